@@ -11,7 +11,20 @@
 #pragma once
 
 #include "lemlib/util.hpp"
+#include "lemlib/clock.hpp"
+#include "lemlib/autotune.hpp"
+#include "lemlib/characterize.hpp"
+#include "lemlib/gainSchedule.hpp"
+#include "lemlib/motionProfile.hpp"
 #include "lemlib/pid.hpp"
+#include "lemlib/pidBank.hpp"
 #include "lemlib/pose.hpp"
+#include "lemlib/filter.hpp"
+#include "lemlib/telemetry.hpp"
 #include "lemlib/chassis/trackingWheel.hpp"
 #include "lemlib/chassis/chassis.hpp"
+#include "lemlib/chassis/imuFusion.hpp"
+#include "lemlib/chassis/latency.hpp"
+#include "lemlib/chassis/odom.hpp"
+#include "lemlib/chassis/recorder.hpp"
+#include "lemlib/chassis/relocalize.hpp"
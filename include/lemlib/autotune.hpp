@@ -0,0 +1,105 @@
+/**
+ * @file include/lemlib/autotune.hpp
+ * @author LemLib Team
+ * @brief Relay feedback autotuner declarations
+ * @version 0.4.5
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#pragma once
+
+#include <cstdint>
+
+namespace lemlib {
+/**
+ * @brief Struct containing the settings for relay feedback autotuning
+ *
+ * @param relayAmplitude output of the relay, in the same units as the controller output (usually motor power)
+ * @param hysteresis how far the error must cross 0 before the relay switches. Stops sensor noise from switching it.
+ * In the same units as the error
+ * @param cycles number of oscillations to measure. The first oscillation is never measured
+ * @param timeout longest time the autotuner can run, in milliseconds
+ */
+typedef struct {
+        float relayAmplitude;
+        float hysteresis;
+        int cycles;
+        int timeout;
+} AutotuneSettings_t;
+
+/**
+ * @brief Struct containing the result of relay feedback autotuning
+ *
+ * The gains are for a FAPID updated every 10 milliseconds, and use the Ziegler-Nichols PD rule
+ *
+ * @param success whether enough oscillations were measured before the timeout
+ * @param ultimateGain the proportional gain at which the system oscillates steadily
+ * @param ultimatePeriod the period of the oscillation in milliseconds
+ * @param kP proposed proportional gain
+ * @param kD proposed derivative gain
+ */
+typedef struct {
+        bool success;
+        float ultimateGain;
+        float ultimatePeriod;
+        float kP;
+        float kD;
+} AutotuneResult_t;
+
+/**
+ * @brief Relay feedback autotuner, in the style of Astrom and Hagglund
+ *
+ * Instead of a controller, a relay with hysteresis drives the system. The system oscillates around the target, and
+ * the amplitude and period of the oscillation give the ultimate gain and period, from which gains are proposed.
+ * The autotuner only sees errors and timestamps, so it can run on the robot or against a simulation
+ */
+class RelayAutotuner {
+    public:
+        /**
+         * @brief Construct a new Relay Autotuner
+         *
+         * @param settings the autotuning settings
+         */
+        RelayAutotuner(AutotuneSettings_t settings);
+        /**
+         * @brief Update the relay
+         *
+         * @param error the target value minus the current value
+         * @param timeMs the current time in milliseconds
+         * @return float the output to apply to the system
+         */
+        float update(float error, std::uint32_t timeMs);
+        /**
+         * @brief Whether enough oscillations have been measured
+         *
+         * @return true if the result is ready
+         */
+        bool isDone();
+        /**
+         * @brief Get the result. The gains are 0 if it isn't done
+         *
+         * @return AutotuneResult_t
+         */
+        AutotuneResult_t getResult();
+        /**
+         * @brief Reset the autotuner, so it can run again
+         *
+         */
+        void reset();
+    private:
+        AutotuneSettings_t settings;
+        float output = 0;
+        // error extremes since the relay last switched high
+        float maxError = 0;
+        float minError = 0;
+        int switches = 0; // number of times the relay switched high
+        std::uint32_t lastSwitchTime = 0;
+        // sums over the measured oscillations
+        float amplitudeSum = 0;
+        float periodSum = 0;
+        int measured = 0;
+};
+} // namespace lemlib
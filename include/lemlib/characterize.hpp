@@ -0,0 +1,121 @@
+/**
+ * @file include/lemlib/characterize.hpp
+ * @author LemLib Team
+ * @brief Drivetrain characterization declarations
+ * @version 0.4.5
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#pragma once
+
+namespace lemlib {
+/**
+ * @brief Struct containing feedforward gains
+ *
+ * The feedforward is kS * sign(velocity) + kV * velocity + kA * acceleration, in motor power. The velocity and
+ * acceleration are in inches for lateral motion and degrees for angular motion
+ *
+ * @param kS power needed to overcome static friction
+ * @param kV power per unit of velocity
+ * @param kA power per unit of acceleration
+ */
+typedef struct {
+        float kS;
+        float kV;
+        float kA;
+} Feedforward_t;
+
+/**
+ * @brief Struct containing the settings for drivetrain characterization
+ *
+ * @param rampRate how fast the power rises during the quasi-static tests, in motor power per second
+ * @param stepPower the power applied during the step tests
+ * @param maxDistance how far the robot can drive during each test, in inches
+ * @param timeout longest time each test can run, in milliseconds
+ * @param minVelocity samples slower than this, in inches per second, are not used. The robot hasn't broken static
+ * friction yet, so they don't follow the model
+ */
+typedef struct {
+        float rampRate;
+        float stepPower;
+        float maxDistance;
+        int timeout;
+        float minVelocity;
+} CharacterizeSettings_t;
+
+/**
+ * @brief Struct containing the result of drivetrain characterization
+ *
+ * The gains of each side are in motor power, inches per second and inches per second squared of that side
+ *
+ * @param success whether both sides could be fitted
+ * @param left feedforward of the left side
+ * @param right feedforward of the right side
+ */
+typedef struct {
+        bool success;
+        Feedforward_t left;
+        Feedforward_t right;
+} CharacterizationResult_t;
+
+/**
+ * @brief Least squares fit of feedforward gains
+ *
+ * Only the sums of the normal equations are stored, so samples can be added forever without using more memory
+ */
+class FeedforwardFit {
+    public:
+        /**
+         * @brief Add a sample
+         *
+         * @param power the power applied
+         * @param velocity the measured velocity
+         * @param acceleration the measured acceleration
+         */
+        void addSample(float power, float velocity, float acceleration);
+        /**
+         * @brief Fit the gains to the samples added so far
+         *
+         * @param gains the fitted gains. Unchanged if the fit fails
+         * @return true if there were enough varied samples to fit the gains
+         */
+        bool solve(Feedforward_t& gains);
+        /**
+         * @brief Get the number of samples added
+         *
+         * @return int
+         */
+        int getCount();
+        /**
+         * @brief Remove all the samples
+         *
+         */
+        void reset();
+    private:
+        // sums of the products of the regressors (sign of velocity, velocity, acceleration) and the power
+        double xx[3][3] = {};
+        double xy[3] = {};
+        int count = 0;
+};
+
+/**
+ * @brief Save a characterization result to a file
+ *
+ * @param filePath file path to save to. No need to preface it with /usd/
+ * @param result the result to save
+ * @return true if the file was written
+ */
+bool saveCharacterization(const char* filePath, const CharacterizationResult_t& result);
+
+/**
+ * @brief Load a characterization result from a file
+ *
+ * @param filePath file path to load from. No need to preface it with /usd/
+ * @param result the loaded result. Unchanged if the file couldn't be read
+ * @return true if the file was read
+ */
+bool loadCharacterization(const char* filePath, CharacterizationResult_t& result);
+} // namespace lemlib
@@ -11,10 +11,16 @@
 
 #pragma once
 
+#include <cstdint>
 #include "pros/motors.hpp"
 #include "pros/imu.hpp"
 #include "lemlib/chassis/trackingWheel.hpp"
 #include "lemlib/pose.hpp"
+#include "lemlib/filter.hpp"
+#include "lemlib/autotune.hpp"
+#include "lemlib/characterize.hpp"
+#include "lemlib/gainSchedule.hpp"
+#include "lemlib/motionProfile.hpp"
 
 namespace lemlib {
 /**
@@ -29,6 +35,7 @@ namespace lemlib {
  * @param horizontal1 pointer to the first horizontal tracking wheel
  * @param horizontal2 pointer to the second horizontal tracking wheel
  * @param imu pointer to the IMU
+ * @param extraImus pointers to up to 3 more IMUs, fused with imu. Optional, imu must be set to use them
  */
 typedef struct {
         TrackingWheel* vertical1;
@@ -36,8 +43,53 @@ typedef struct {
         TrackingWheel* horizontal1;
         TrackingWheel* horizontal2;
         pros::Imu* imu;
+        pros::Imu* extraImus[3];
 } OdomSensors_t;
 
+/**
+ * @brief Struct containing a single reading of every odometry sensor
+ *
+ * Each configured sensor is read exactly once per odometry tick and stored here, so odometry, chassis motions and
+ * telemetry all see the same values. Sensors that are not configured read as 0
+ *
+ * @param vertical1 distance traveled by the first vertical tracking wheel in inches
+ * @param vertical2 distance traveled by the second vertical tracking wheel in inches
+ * @param horizontal1 distance traveled by the first horizontal tracking wheel in inches
+ * @param horizontal2 distance traveled by the second horizontal tracking wheel in inches
+ * @param imu rotation of the IMU in radians. Fused rotation of all the IMUs if there are several
+ * @param time time the snapshot was taken, in milliseconds
+ * @param leftDrive distance traveled by the left side of the drivetrain in inches. Only sampled for slip detection
+ * @param rightDrive distance traveled by the right side of the drivetrain in inches. Only sampled for slip detection
+ * @param imuAccel horizontal acceleration measured by the IMU in g. Only sampled for slip detection
+ * @param imus rotation of each IMU in radians before fusion. Only sampled if there are several IMUs
+ * @param vertical1Velocity velocity of the first vertical tracking wheel in inches per second
+ * @param vertical2Velocity velocity of the second vertical tracking wheel in inches per second
+ * @param horizontal1Velocity velocity of the first horizontal tracking wheel in inches per second
+ * @param horizontal2Velocity velocity of the second horizontal tracking wheel in inches per second
+ * @param leftDriveVelocity velocity of the left side of the drivetrain in inches per second. Only sampled for slip
+ * detection
+ * @param rightDriveVelocity velocity of the right side of the drivetrain in inches per second. Only sampled for slip
+ * detection
+ */
+typedef struct {
+        float vertical1;
+        float vertical2;
+        float horizontal1;
+        float horizontal2;
+        float imu;
+        std::uint32_t time;
+        float leftDrive;
+        float rightDrive;
+        float imuAccel;
+        float imus[4];
+        float vertical1Velocity;
+        float vertical2Velocity;
+        float horizontal1Velocity;
+        float horizontal2Velocity;
+        float leftDriveVelocity;
+        float rightDriveVelocity;
+} SensorSnapshot_t;
+
 /**
  * @brief Struct containing constants for a chassis controller
  *
@@ -51,6 +103,10 @@ typedef struct {
  * @param largeError the error at which the chassis controller will switch to a faster control loop
  * @param largeErrorTimeout the time the chassis controller will wait before switching to a faster control loop
  * @param slew the maximum acceleration of the chassis controller
+ * @param schedule gain schedule to scale kP and kD with. Optional, can be left out or set to nullptr
+ * @param settleError the error below which the controller can exit early once the robot stops. Optional
+ * @param settleSpeed the speed, in error units per second, below which the robot is considered stopped. Optional, 0
+ * disables the early exit
  */
 typedef struct {
         float kP;
@@ -60,6 +116,9 @@ typedef struct {
         float largeError;
         float largeErrorTimeout;
         float slew;
+        const GainSchedule* schedule;
+        float settleError;
+        float settleSpeed;
 } ChassisController_t;
 
 /**
@@ -126,6 +185,55 @@ class Chassis {
          * @return Pose
          */
         Pose getPose(bool radians = false);
+        /**
+         * @brief Get the pose the chassis is expected to be at after some time
+         *
+         * @param dtMs how far ahead to predict, in milliseconds
+         * @param radians whether theta should be in radians (true) or degrees (false). false by default
+         * @return Pose
+         */
+        Pose getPredictedPose(float dtMs, bool radians = false);
+        /**
+         * @brief Set how far ahead motions predict the pose to compensate for latency
+         *
+         * Motor commands act some time after the pose was measured. When set, turnTo(), moveTo() and follow() run
+         * their controllers on the pose predicted this far ahead instead of the latest pose
+         *
+         * @param latencyMs the latency to compensate for in milliseconds. 0 to disable, which is the default
+         */
+        void setPrediction(float latencyMs);
+        /**
+         * @brief Get the velocity of the chassis
+         *
+         * @param local true for the robot frame (x to the right, y forwards), false for the field frame. False by
+         * default
+         * @param radians true for angular velocity in radians per second, false for degrees per second. False by
+         * default
+         * @return Pose velocity in inches per second
+         */
+        Pose getVelocity(bool local = false, bool radians = false);
+        /**
+         * @brief Get the acceleration of the chassis
+         *
+         * @param local true for the robot frame (x to the right, y forwards), false for the field frame. False by
+         * default
+         * @param radians true for angular acceleration in radians per second squared, false for degrees. False by
+         * default
+         * @return Pose acceleration in inches per second squared
+         */
+        Pose getAcceleration(bool local = false, bool radians = false);
+        /**
+         * @brief Set the filter used by odometry to estimate velocity and acceleration
+         *
+         * @param settings the filter settings
+         */
+        void setVelocityFilter(FilterSettings_t settings);
+        /**
+         * @brief Get the most recent sensor snapshot taken by odometry
+         *
+         * @return SensorSnapshot_t
+         */
+        SensorSnapshot_t getSensorSnapshot();
         /**
          * @brief Turn the chassis so it is facing the target point
          *
@@ -164,7 +272,112 @@ class Chassis {
          */
         void follow(const char* filePath, int timeout, float lookahead, bool reverse = false, float maxSpeed = 127,
                     bool log = false);
+        /**
+         * @brief Set the feedforward gains used by profiled motions
+         *
+         * @param lateral feedforward for driving, with velocity in inches per second
+         * @param angular feedforward for turning, with velocity in degrees per second
+         */
+        void setFeedforward(Feedforward_t lateral, Feedforward_t angular);
+        /**
+         * @brief Set the feedforward gains used by profiled motions from a characterization of the drivetrain
+         *
+         * The lateral gains are the average of both sides. The angular gains assume the sides move at the track
+         * width, so they don't account for scrub and may need to be raised slightly
+         *
+         * @param result the characterization of the drivetrain
+         */
+        void setFeedforward(CharacterizationResult_t result);
+        /**
+         * @brief Set the feedforward gains used by profiled motions from a saved characterization
+         *
+         * @param filePath file path to the characterization. No need to preface it with /usd/
+         * @return true if the characterization was loaded
+         */
+        bool loadFeedforward(const char* filePath);
+        /**
+         * @brief Measure the feedforward gains of each side of the drivetrain
+         *
+         * The robot drives forwards then backwards with slowly rising power (quasi-static tests), then forwards then
+         * backwards at a constant power (step tests). The velocity of each side is measured by its motors, and kS, kV
+         * and kA are fitted by least squares. Give the robot room to drive maxDistance in front of it. If the fit
+         * succeeds, the gains are used by profiled motions straight away
+         *
+         * @param settings the characterization settings
+         * @param filePath file path to save the result to, so it can be loaded with loadFeedforward(). No need to
+         * preface it with /usd/. nullptr to not save it, which is the default
+         * @param log whether to log every sample, including the velocity measured by the vertical tracking wheels.
+         * false by default
+         * @return CharacterizationResult_t the fitted gains of each side
+         */
+        CharacterizationResult_t characterize(CharacterizeSettings_t settings = {12, 80, 48, 6000, 1},
+                                              const char* filePath = nullptr, bool log = false);
+        /**
+         * @brief Turn the chassis so it is facing the target point, following a motion profile
+         *
+         * The heading follows the profile using the angular feedforward, and the angular controller corrects the
+         * difference between the profile and the measured heading. Once the profile ends, the angular controller
+         * holds the final heading until it settles. The profile is slowed to a velocity the feedforward can hold within
+         * maxSpeed, and the output is slew limited and capped like moveTo()
+         *
+         * The PID logging id is "angularPID"
+         *
+         * @param x x location
+         * @param y y location
+         * @param timeout longest time the robot can spend moving
+         * @param constraints the velocity and acceleration limits, in degrees per second and degrees per second squared
+         * @param shape the shape of the profile. S_CURVE by default
+         * @param reversed whether the robot should turn in the opposite direction. false by default
+         * @param maxSpeed the maximum speed the robot can turn at. Default is 127
+         * @param log whether the chassis should log the turnTo function. false by default
+         */
+        void turnToProfiled(float x, float y, int timeout, ProfileConstraints_t constraints,
+                            ProfileShape shape = ProfileShape::S_CURVE, bool reversed = false, float maxSpeed = 127,
+                            bool log = false);
+        /**
+         * @brief Move the chassis to the target point, following a motion profile
+         *
+         * The distance to the target follows the profile using the lateral feedforward, and the lateral controller
+         * corrects the difference between the profile and the measured progress. The angular controller keeps the
+         * robot pointed at the target, like moveTo(). The robot drives backwards if it starts facing away from the
+         * target. The profile is slowed to a velocity the feedforward can hold within maxSpeed, and the output is slew
+         * limited and capped like moveTo()
+         *
+         * The PID logging ids are "angularPID" and "lateralPID"
+         *
+         * @param x x location
+         * @param y y location
+         * @param timeout longest time the robot can spend moving
+         * @param constraints the velocity and acceleration limits, in inches per second and inches per second squared
+         * @param shape the shape of the profile. S_CURVE by default
+         * @param maxSpeed the maximum speed the robot can move at. Default is 127
+         * @param log whether the chassis should log the moveTo function. false by default
+         */
+        void moveToProfiled(float x, float y, int timeout, ProfileConstraints_t constraints,
+                            ProfileShape shape = ProfileShape::S_CURVE, float maxSpeed = 127, bool log = false);
+        /**
+         * @brief Find gains for a chassis controller by oscillating the drivetrain around its current pose
+         *
+         * The drivetrain is driven back and forth (lateral) or turned back and forth (angular) by a relay, and gains
+         * are proposed from the measured oscillation. Give the robot room to move a few inches or degrees either way.
+         * The proposed gains can be copied into the ChassisController_t
+         *
+         * @param angular true to tune the angular controller, false to tune the lateral controller
+         * @param settings the autotuning settings. The hysteresis is in degrees for angular, inches for lateral
+         * @return AutotuneResult_t the measured oscillation and proposed gains
+         */
+        AutotuneResult_t autotune(bool angular, AutotuneSettings_t settings = {40, 0.5, 4, 10000});
     private:
+        /**
+         * @brief Get the pose used by the motion controllers
+         *
+         * @param radians whether theta should be in radians (true) or degrees (false). false by default
+         * @return Pose the predicted pose if prediction is enabled, otherwise the latest pose
+         */
+        Pose getControlPose(bool radians = false);
+        float predictionLatency = 0;
+        Feedforward_t lateralFeedforward = {0, 0, 0};
+        Feedforward_t angularFeedforward = {0, 0, 0};
         ChassisController_t lateralSettings;
         ChassisController_t angularSettings;
         Drivetrain_t drivetrain;
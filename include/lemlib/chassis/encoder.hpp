@@ -0,0 +1,144 @@
+/**
+ * @file include/lemlib/chassis/encoder.hpp
+ * @author LemLib Team
+ * @brief Encoder backends used by tracking wheels
+ * @version 0.4.5
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#pragma once
+
+#include <cstdint>
+#include "pros/motors.hpp"
+#include "pros/adi.hpp"
+#include "pros/rotation.hpp"
+
+namespace lemlib {
+/**
+ * @brief A motor group read as a single encoder
+ *
+ * The port and gearing of every motor are cached, so reading the motors doesn't allocate. The position is the
+ * average number of rotations of the drivetrain wheels
+ */
+class MotorGroupEncoder {
+    public:
+        static constexpr int MAX_MOTORS = 8;
+        /**
+         * @brief Create a new motor group encoder
+         *
+         * @param motors the motor group to use
+         * @param rpm theoretical maximum rpm of the drivetrain wheels
+         */
+        MotorGroupEncoder(pros::Motor_Group* motors, float rpm);
+        /**
+         * @brief Get the average number of rotations of the drivetrain wheels
+         *
+         * @return float rotations
+         */
+        float getPosition();
+        /**
+         * @brief Get the average velocity of the drivetrain wheels, as measured by the motors
+         *
+         * @return float rotations per second
+         */
+        float getVelocity();
+        /**
+         * @brief Reset the position to 0, and read the gearing of the motors again in case a motor wasn't connected
+         * before
+         *
+         */
+        void reset();
+    private:
+        void cacheMotors();
+
+        pros::Motor_Group* motors;
+        float rpm;
+        std::uint8_t ports[MAX_MOTORS];
+        float ratios[MAX_MOTORS]; // wheel rotations per motor rotation
+        int motorCount = 0;
+};
+
+/**
+ * @brief An encoder whose position is set by hand. Useful for testing odometry without a robot
+ *
+ * @param position the position in rotations
+ * @param velocity the velocity in rotations per second
+ */
+typedef struct {
+        float position;
+        float velocity;
+} MockEncoder_t;
+
+/**
+ * @brief How a tracking wheel reads and resets a device
+ *
+ * Each specialization provides:
+ * Device: the device type
+ * UNITS_PER_ROTATION: how many units read() returns for a full rotation of the device
+ * POWERED: whether the device is driven by motors
+ * NATIVE_VELOCITY: whether the device measures its own velocity. If not, it is calculated from the position
+ * VELOCITY_SMOOTHING: weight of each new velocity reading in the low-pass filter (0 to 1). 1 is no filtering
+ * read(): the position of the device
+ * velocity(): the velocity of the device in units per second. Only called if NATIVE_VELOCITY is true
+ * reset(): reset the position of the device to 0
+ *
+ * @tparam Device the device type
+ */
+template <typename Device> struct EncoderPolicy;
+
+template <> struct EncoderPolicy<pros::ADIEncoder> {
+        static constexpr float UNITS_PER_ROTATION = 360;
+        static constexpr bool POWERED = false;
+        // finite differences of a 360 tick encoder are coarse, so filter them heavily
+        static constexpr bool NATIVE_VELOCITY = false;
+        static constexpr float VELOCITY_SMOOTHING = 0.3;
+
+        static float read(pros::ADIEncoder* encoder) { return encoder->get_value(); }
+
+        static void reset(pros::ADIEncoder* encoder) { encoder->reset(); }
+};
+
+template <> struct EncoderPolicy<pros::Rotation> {
+        static constexpr float UNITS_PER_ROTATION = 36000;
+        static constexpr bool POWERED = false;
+        static constexpr bool NATIVE_VELOCITY = true;
+        static constexpr float VELOCITY_SMOOTHING = 0.5;
+
+        static float read(pros::Rotation* rotation) { return rotation->get_position(); }
+
+        // centidegrees per second
+        static float velocity(pros::Rotation* rotation) { return rotation->get_velocity(); }
+
+        static void reset(pros::Rotation* rotation) { rotation->reset_position(); }
+};
+
+template <> struct EncoderPolicy<MotorGroupEncoder> {
+        static constexpr float UNITS_PER_ROTATION = 1;
+        static constexpr bool POWERED = true;
+        // the motors already filter their velocity
+        static constexpr bool NATIVE_VELOCITY = true;
+        static constexpr float VELOCITY_SMOOTHING = 1;
+
+        static float read(MotorGroupEncoder* motors) { return motors->getPosition(); }
+
+        static float velocity(MotorGroupEncoder* motors) { return motors->getVelocity(); }
+
+        static void reset(MotorGroupEncoder* motors) { motors->reset(); }
+};
+
+template <> struct EncoderPolicy<MockEncoder_t> {
+        static constexpr float UNITS_PER_ROTATION = 1;
+        static constexpr bool POWERED = false;
+        static constexpr bool NATIVE_VELOCITY = true;
+        static constexpr float VELOCITY_SMOOTHING = 1;
+
+        static float read(MockEncoder_t* encoder) { return encoder->position; }
+
+        static float velocity(MockEncoder_t* encoder) { return encoder->velocity; }
+
+        static void reset(MockEncoder_t* encoder) { encoder->position = 0; }
+};
+} // namespace lemlib
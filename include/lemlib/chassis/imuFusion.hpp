@@ -0,0 +1,100 @@
+/**
+ * @file include/lemlib/chassis/imuFusion.hpp
+ * @author LemLib Team
+ * @brief Multi-IMU heading fusion declarations
+ * @version 0.4.5
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#pragma once
+
+namespace lemlib {
+/**
+ * @brief Struct containing the settings for IMU fusion
+ *
+ * @param outlierThreshold how far in radians an IMU's change in rotation in one tick can differ from the others
+ * before it is ignored for that tick
+ * @param biasRate how quickly the bias of each IMU is learned while the robot is stationary (0 to 1)
+ * @param scaleRate how quickly the scale of each IMU is learned while the robot is turning (0 to 1)
+ * @param minScaleRotation the smallest change in rotation in radians per tick used to learn scale
+ */
+typedef struct {
+        float outlierThreshold;
+        float biasRate;
+        float scaleRate;
+        float minScaleRotation;
+} FusionSettings_t;
+
+/**
+ * @brief Fuses the rotation of several IMUs into a single rotation
+ *
+ * Every tick the change in rotation of each IMU is corrected for its estimated bias and scale. IMUs that disagree
+ * with the median are rejected, and the rest are averaged. Bias is learned while the robot is stationary, and scale
+ * relative to the other IMUs is learned while it turns
+ */
+class ImuFusion {
+    public:
+        /** @brief the largest number of IMUs that can be fused */
+        static constexpr int MAX_IMUS = 4;
+        /**
+         * @brief Construct a new Imu Fusion
+         *
+         * @param settings the fusion settings
+         */
+        ImuFusion(FusionSettings_t settings = {0.005, 0.01, 0.001, 0.005});
+        /**
+         * @brief Add the readings of a tick
+         *
+         * @param rotations the rotation of each IMU in radians. Readings that aren't finite are ignored
+         * @param count the number of IMUs
+         * @param dt time since the last tick in seconds
+         * @param stationary whether the robot is known to be stationary, for example because no tracking wheel moved
+         * @return float the fused rotation in radians
+         */
+        float update(const float* rotations, int count, float dt, bool stationary);
+        /**
+         * @brief Reset the fused rotation, keeping the learned bias and scale
+         *
+         * @param rotation the new fused rotation in radians
+         */
+        void reset(float rotation = 0);
+        /**
+         * @brief Change the fusion settings, keeping the fused rotation and the learned bias and scale
+         *
+         * @param settings the new fusion settings
+         */
+        void setSettings(FusionSettings_t settings);
+        /**
+         * @brief Get the estimated bias of an IMU
+         *
+         * @param index the index of the IMU
+         * @return float bias in radians per second
+         */
+        float getBias(int index);
+        /**
+         * @brief Get the estimated scale of an IMU relative to the others
+         *
+         * @param index the index of the IMU
+         * @return float scale
+         */
+        float getScale(int index);
+        /**
+         * @brief Get the number of IMUs used in the last tick
+         *
+         * @return int
+         */
+        int getValidCount();
+    private:
+        FusionSettings_t settings;
+        bool initialized = false;
+        float rotation = 0;
+        float prevRotations[MAX_IMUS] = {0};
+        float bias[MAX_IMUS] = {0};
+        float scale[MAX_IMUS] = {1, 1, 1, 1};
+        float lastDelta = 0;
+        int validCount = 0;
+};
+} // namespace lemlib
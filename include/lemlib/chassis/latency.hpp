@@ -0,0 +1,76 @@
+/**
+ * @file include/lemlib/chassis/latency.hpp
+ * @author LemLib Team
+ * @brief Sensor read latency histogram declarations
+ * @version 0.4.5
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#pragma once
+
+#include <cstdint>
+
+namespace lemlib {
+/**
+ * @brief Histogram of how long something takes, with power of 2 buckets
+ *
+ * Bucket 0 counts durations under 1 microsecond, and bucket i counts durations from 2^(i-1) up to 2^i microseconds.
+ * Durations that don't fit are counted in the last bucket. Recording is a few instructions, so it can be used in the
+ * odometry loop
+ */
+class LatencyHistogram {
+    public:
+        static constexpr int BUCKETS = 16;
+        /**
+         * @brief Record a duration
+         *
+         * @param micros the duration in microseconds
+         */
+        void record(std::uint32_t micros);
+        /**
+         * @brief Clear every recorded duration
+         *
+         */
+        void reset();
+        /**
+         * @brief Get the number of recorded durations
+         *
+         * @return std::uint32_t
+         */
+        std::uint32_t getCount() const;
+        /**
+         * @brief Get the number of recorded durations in a bucket
+         *
+         * @param bucket the bucket, from 0 to BUCKETS - 1
+         * @return std::uint32_t
+         */
+        std::uint32_t getBucket(int bucket) const;
+        /**
+         * @brief Get the mean duration
+         *
+         * @return float mean in microseconds, 0 if nothing was recorded
+         */
+        float getMean() const;
+        /**
+         * @brief Get the longest duration
+         *
+         * @return std::uint32_t longest duration in microseconds
+         */
+        std::uint32_t getMax() const;
+        /**
+         * @brief Get an upper bound on a percentile of the durations
+         *
+         * @param percentile the percentile, from 0 to 100
+         * @return std::uint32_t upper edge of the bucket the percentile falls in, in microseconds
+         */
+        std::uint32_t getPercentile(float percentile) const;
+    private:
+        std::uint32_t buckets[BUCKETS] = {};
+        std::uint32_t count = 0;
+        std::uint64_t total = 0;
+        std::uint32_t max = 0;
+};
+} // namespace lemlib
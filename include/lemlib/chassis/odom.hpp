@@ -1,8 +1,8 @@
 /**
  * @file include/lemlib/chassis/odom.hpp
  * @author LemLib Team
- * @brief This is the header file for the odom.cpp file. Its not meant to be used directly, only through the chassis
- * class
+ * @brief This is the header file for the odom.cpp file. The free functions are meant to be used through the chassis
+ * class, the Odometry class can be used directly to run extra estimators
  * @version 0.4.5
  * @date 2023-01-23
  *
@@ -12,17 +12,419 @@
 
 #pragma once
 
+#include "pros/rtos.hpp"
+#include "lemlib/filter.hpp"
 #include "lemlib/chassis/chassis.hpp"
+#include "lemlib/chassis/imuFusion.hpp"
+#include "lemlib/chassis/latency.hpp"
 #include "lemlib/pose.hpp"
 
 namespace lemlib {
+class WallRelocalizer;
+
+/**
+ * @brief The sensors used to calculate the heading of the robot
+ *
+ * HORIZONTAL_WHEELS: the difference between the two horizontal tracking wheels
+ * VERTICAL_WHEELS: the difference between the two unpowered vertical tracking wheels
+ * IMU: the inertial sensor
+ * DRIVETRAIN: the difference between the two vertical tracking wheels, at least one of which is the drivetrain
+ */
+enum class HeadingSource { HORIZONTAL_WHEELS, VERTICAL_WHEELS, IMU, DRIVETRAIN };
+
+/**
+ * @brief The sensor reads that odometry can time
+ *
+ * IMU1 is the main IMU, IMU2 to IMU4 are the extra IMUs. IMU_ACCEL is the acceleration read used for impact detection.
+ * SAMPLE is the time taken to sample every sensor once
+ */
+enum class SensorDevice {
+    VERTICAL1,
+    VERTICAL2,
+    HORIZONTAL1,
+    HORIZONTAL2,
+    LEFT_DRIVE,
+    RIGHT_DRIVE,
+    IMU1,
+    IMU2,
+    IMU3,
+    IMU4,
+    IMU_ACCEL,
+    SAMPLE
+};
+
+/**
+ * @brief Struct containing the settings for slip and impact detection
+ *
+ * @param slipThreshold how far in inches a source's forward travel in one tick can differ from the others before it
+ * is considered slipping
+ * @param impactThreshold horizontal IMU acceleration in g that is considered an impact. The drivetrain is ignored
+ * during an impact
+ * @param recoveryRate weight a source regains each tick once it agrees with the others again (0 to 1)
+ * @param drivetrainWeight weight of each side of the drivetrain when an unpowered vertical tracking wheel is also
+ * used (0 to 1)
+ */
+typedef struct {
+        float slipThreshold;
+        float impactThreshold;
+        float recoveryRate;
+        float drivetrainWeight;
+} SlipSettings_t;
+
+/**
+ * @brief Odometry estimator
+ *
+ * The sensor layout and heading source are resolved once when the estimator is constructed, so updating it only
+ * does the math for that layout. Several estimators can be fed the same sensor snapshot, for example to compare a
+ * primary and a shadow configuration live
+ */
+class Odometry {
+    public:
+        /**
+         * @brief Construct an estimator without any sensors. Its pose never changes
+         *
+         */
+        Odometry();
+        /**
+         * @brief Construct a new Odometry estimator
+         *
+         * The heading source is chosen in this order of priority:
+         * 1. Horizontal tracking wheels
+         * 2. Vertical tracking wheels
+         * 3. Inertial Sensor
+         * 4. Drivetrain
+         *
+         * @param sensors the sensors to be used
+         * @param drivetrain drivetrain to be used
+         */
+        Odometry(OdomSensors_t sensors, Drivetrain_t drivetrain);
+        /**
+         * @brief Construct a new Odometry estimator with a specific heading source
+         *
+         * If the sensors needed by the heading source are not configured, it is chosen automatically instead
+         *
+         * @param sensors the sensors to be used
+         * @param drivetrain drivetrain to be used
+         * @param headingSource the sensors used to calculate the heading
+         */
+        Odometry(OdomSensors_t sensors, Drivetrain_t drivetrain, HeadingSource headingSource);
+        /**
+         * @brief Destroy the Odometry estimator, and the drivetrain tracking wheels it created for slip detection
+         *
+         */
+        ~Odometry();
+        /**
+         * @brief Reconfigure the estimator for new sensors, keeping its pose
+         *
+         * The heading source is chosen automatically. Motion is measured from the first snapshot after this, so the
+         * readings the new sensors already had aren't applied as a jump
+         *
+         * @param sensors the sensors to be used
+         * @param drivetrain drivetrain to be used
+         */
+        void setSensors(OdomSensors_t sensors, Drivetrain_t drivetrain);
+        /**
+         * @brief Read every configured sensor once
+         *
+         * @return SensorSnapshot_t the sensor readings
+         */
+        SensorSnapshot_t sample();
+        /**
+         * @brief Update the pose using a sensor snapshot
+         *
+         * The snapshot must come from an estimator configured with the same sensors, or a superset of them. The first
+         * snapshot an estimator sees is only used as the starting point, so an estimator can start at any time
+         *
+         * @param snapshot the sensor readings for this tick
+         */
+        void update(const SensorSnapshot_t& snapshot);
+        /**
+         * @brief Sample the sensors and update the pose
+         *
+         */
+        void update();
+        /**
+         * @brief Get the pose
+         *
+         * @param radians true for theta in radians, false for degrees. False by default
+         * @return Pose
+         */
+        Pose getPose(bool radians = false);
+        /**
+         * @brief Get the pose the robot is expected to be at after some time
+         *
+         * The latest pose is integrated forwards assuming the current robot-frame velocity stays constant
+         *
+         * @param dtMs how far ahead to predict, in milliseconds
+         * @param radians true for theta in radians, false for degrees. False by default
+         * @return Pose
+         */
+        Pose getPredictedPose(float dtMs, bool radians = false);
+        /**
+         * @brief Set the pose
+         *
+         * Takes the tracking lock, so the tracking task can't overwrite the new pose with one it was still
+         * calculating. Safe to call while the tracking task is running
+         *
+         * @param pose the new pose
+         * @param radians true if theta is in radians, false if in degrees. False by default
+         */
+        void setPose(Pose pose, bool radians = false);
+        /**
+         * @brief Shift the x and y of the pose
+         *
+         * The shift is blended into the pose over the next few ticks instead of all at once, so running motions don't
+         * see a jump. Safe to call from any task
+         *
+         * @param dx shift in the x direction in inches
+         * @param dy shift in the y direction in inches
+         */
+        void correct(float dx, float dy);
+        /**
+         * @brief Get the part of the corrections that hasn't been blended into the pose yet
+         *
+         * @return Pose the remaining shift. Theta is always 0
+         */
+        Pose getPendingCorrection();
+        /**
+         * @brief Set how quickly corrections are blended into the pose
+         *
+         * @param rate fraction of the remaining correction applied each tick (0 to 1). 0.1 by default
+         */
+        void setCorrectionRate(float rate);
+        /**
+         * @brief Set a relocalizer to correct the pose every tick
+         *
+         * The relocalizer is skipped during impacts. Sensors it can't trust are ignored, so it only corrects the pose
+         * when a wall is clearly in view
+         *
+         * @param relocalizer the relocalizer to run, or nullptr to stop. Must stay alive while it is set
+         */
+        void setRelocalizer(WallRelocalizer* relocalizer);
+        /**
+         * @brief Set whether the pose is accumulated in double precision
+         *
+         * The motion of each tick is still calculated in float, but adding it to a large float pose loses the low
+         * bits every tick. Accumulating in double stops that rounding from building up over long runs
+         *
+         * @param enabled true to accumulate the pose in double precision. False by default
+         */
+        void setDoublePrecision(bool enabled);
+        /**
+         * @brief Enable or disable slip and impact detection
+         *
+         * When enabled, the forward travel of the vertical tracking wheel and both sides of the drivetrain are
+         * compared every tick. Sources that disagree with the others, and the drivetrain during an impact, are
+         * weighted down until they agree again. Works best with an IMU as the heading source
+         *
+         * @param enabled whether slip detection should be enabled
+         * @param settings the slip detection settings
+         */
+        void setSlipDetection(bool enabled, SlipSettings_t settings = {0.05, 1.5, 0.02, 0.25});
+        /**
+         * @brief Whether any forward travel source is currently weighted down because it slipped
+         *
+         * @return true if a source is slipping
+         */
+        bool isSlipping();
+        /**
+         * @brief Whether the last tick detected an impact
+         *
+         * @return true if the IMU acceleration exceeded the impact threshold
+         */
+        bool isImpact();
+        /**
+         * @brief Set the settings used to fuse the IMUs. Only used if there are several IMUs
+         *
+         * The fused rotation and the learned bias and scale of each IMU are kept, so this can be called while tracking
+         *
+         * @param settings the fusion settings
+         */
+        void setImuFusion(FusionSettings_t settings);
+        /**
+         * @brief Get the IMU fusion, for example to read the estimated bias of each IMU
+         *
+         * @return ImuFusion&
+         */
+        ImuFusion& getImuFusion();
+        /**
+         * @brief Set the filter used to estimate velocity and acceleration
+         *
+         * @param settings the filter settings
+         */
+        void setVelocityFilter(FilterSettings_t settings);
+        /**
+         * @brief Get the velocity
+         *
+         * @param local true for the robot frame (x to the right, y forwards), false for the field frame. False by
+         * default
+         * @param radians true for angular velocity in radians per second, false for degrees per second. False by
+         * default
+         * @return Pose velocity in inches per second
+         */
+        Pose getVelocity(bool local = false, bool radians = false);
+        /**
+         * @brief Get the acceleration
+         *
+         * @param local true for the robot frame (x to the right, y forwards), false for the field frame. False by
+         * default
+         * @param radians true for angular acceleration in radians per second squared, false for degrees. False by
+         * default
+         * @return Pose acceleration in inches per second squared
+         */
+        Pose getAcceleration(bool local = false, bool radians = false);
+        /**
+         * @brief Get the sensor snapshot used by the last update
+         *
+         * @return SensorSnapshot_t
+         */
+        SensorSnapshot_t getSensorSnapshot();
+        /**
+         * @brief Enable or disable timing every sensor read
+         *
+         * When enabled, the time taken by each sensor read is recorded in a histogram. Disabled by default, in which
+         * case sampling isn't slowed down at all
+         *
+         * @param enabled whether sensor reads should be timed
+         */
+        void setLatencyTracking(bool enabled);
+        /**
+         * @brief Get the read latency histogram of a sensor
+         *
+         * @param device the sensor
+         * @return const LatencyHistogram&
+         */
+        const LatencyHistogram& getLatency(SensorDevice device);
+        /**
+         * @brief Clear the read latency histograms of every sensor
+         *
+         */
+        void resetLatency();
+        /**
+         * @brief Log the read latency of every sensor that has been timed
+         *
+         * Logged at the info level, so lemlib::logger::setVerbose(true) must be called first
+         */
+        void logLatency();
+        /**
+         * @brief Get the heading source chosen for this estimator
+         *
+         * @return HeadingSource
+         */
+        HeadingSource getHeadingSource();
+    private:
+        void resolve(HeadingSource headingSource, bool automatic);
+        void resolveSlipSources();
+        float slipCorrectedTravel(const SensorSnapshot_t& snapshot, float deltaHeading);
+        float slipCorrectedVelocity(const SensorSnapshot_t& snapshot, float angularVelocity);
+
+        OdomSensors_t sensors;
+        Drivetrain_t drivetrain;
+
+        // tracking wheels to sample, and the snapshot fields their distance and velocity are stored in
+        TrackingWheel* wheels[6];
+        float SensorSnapshot_t::*wheelReadings[6];
+        float SensorSnapshot_t::*wheelVelocities[6];
+        int wheelCount = 0;
+        int sensorWheelCount = 0; // wheels from the sensors, the rest are only sampled for slip detection
+        SensorDevice wheelDevices[6];
+
+        // IMUs to sample. Fused if there are several
+        pros::Imu* imus[ImuFusion::MAX_IMUS];
+        int imuCount = 0;
+        ImuFusion fusion;
+
+        // resolved layout
+        HeadingSource headingSource = HeadingSource::IMU;
+        float SensorSnapshot_t::*headingA = &SensorSnapshot_t::vertical1;
+        float SensorSnapshot_t::*headingB = &SensorSnapshot_t::vertical2;
+        float headingScale = 0; // 1 / distance between the heading wheels
+        float SensorSnapshot_t::*verticalReading = &SensorSnapshot_t::vertical1;
+        float SensorSnapshot_t::*horizontalReading = &SensorSnapshot_t::horizontal1;
+        float SensorSnapshot_t::*headingVelocityA = &SensorSnapshot_t::vertical1Velocity;
+        float SensorSnapshot_t::*headingVelocityB = &SensorSnapshot_t::vertical2Velocity;
+        float SensorSnapshot_t::*verticalVelocity = &SensorSnapshot_t::vertical1Velocity;
+        float SensorSnapshot_t::*horizontalVelocity = &SensorSnapshot_t::horizontal1Velocity;
+        float verticalScale = 0; // 0 if there is no vertical wheel
+        float horizontalScale = 0; // 0 if there is no horizontal wheel
+        float verticalOffset = 0;
+        float horizontalOffset = 0;
+        bool verticalPowered = false;
+
+        // slip detection. Each source is a measurement of the forward travel of the robot
+        bool slipDetection = false;
+        SlipSettings_t slipSettings = {0.05, 1.5, 0.02, 0.25};
+        // drivetrain tracking wheels created for slip detection, owned by the estimator
+        TrackingWheel* leftDriveWheel = nullptr;
+        TrackingWheel* rightDriveWheel = nullptr;
+        bool driveSeeded = false; // whether prevSnapshot has readings of the drivetrain tracking wheels
+        float SensorSnapshot_t::*slipReadings[3];
+        float SensorSnapshot_t::*slipVelocities[3];
+        float slipOffsets[3];
+        bool slipPowered[3];
+        float slipBaseWeights[3];
+        float slipWeights[3];
+        int slipSourceCount = 0;
+        bool impact = false;
+
+        bool doublePrecision = false;
+
+        // corrections waiting to be blended into the pose, guarded by correctionMutex
+        pros::Mutex correctionMutex;
+        float pendingX = 0;
+        float pendingY = 0;
+        float correctionRate = 0.1;
+        // total correction applied so far. Removed before velocity filtering so corrections don't look like motion
+        float appliedX = 0;
+        float appliedY = 0;
+        WallRelocalizer* relocalizer = nullptr;
+
+        // read latency of each sensor, indexed by SensorDevice
+        bool latencyTracking = false;
+        LatencyHistogram latency[int(SensorDevice::SAMPLE) + 1];
+
+        Pose pose = Pose(0, 0, 0);
+        // double precision copy of the pose, only used if doublePrecision is true
+        double accumulatedX = 0;
+        double accumulatedY = 0;
+        double accumulatedTheta = 0;
+        SensorSnapshot_t snapshot = {};
+        SensorSnapshot_t prevSnapshot = {};
+        bool seeded = false; // whether prevSnapshot holds a snapshot this estimator has seen
+
+        // velocity and acceleration estimators for the field-frame x, y and theta
+        VelocityFilter xFilter;
+        VelocityFilter yFilter;
+        VelocityFilter thetaFilter;
+};
+
 /**
  * @brief Set the sensors to be used for odometry
  *
+ * The primary estimator is reconfigured in place for the new sensors, keeping its pose. Safe to call while the
+ * tracking task is running
+ *
  * @param sensors the sensors to be used
  * @param drivetrain drivetrain to be used
  */
 void setSensors(lemlib::OdomSensors_t sensors, lemlib::Drivetrain_t drivetrain);
+/**
+ * @brief Get the primary odometry estimator
+ *
+ * @return Odometry&
+ */
+Odometry& getOdometry();
+/**
+ * @brief Run another estimator alongside the primary one
+ *
+ * The estimator is updated every tick with the primary estimator's sensor snapshot, so it must use a subset of the
+ * primary estimator's sensors. At most 4 estimators can be added. The estimator measures motion from the first tick
+ * after it is added, so it can be added after the robot has moved
+ *
+ * @param estimator the estimator to add. Must stay alive while odometry is running
+ * @return true if the estimator was added, false if there is no room left
+ */
+bool addEstimator(Odometry* estimator);
 /**
  * @brief Get the pose of the robot
  *
@@ -30,6 +432,14 @@ void setSensors(lemlib::OdomSensors_t sensors, lemlib::Drivetrain_t drivetrain);
  * @return Pose
  */
 Pose getPose(bool radians = false);
+/**
+ * @brief Get the pose the robot is expected to be at after some time
+ *
+ * @param dtMs how far ahead to predict, in milliseconds
+ * @param radians true for theta in radians, false for degrees. False by default
+ * @return Pose
+ */
+Pose getPredictedPose(float dtMs, bool radians = false);
 /**
  * @brief Set the Pose of the robot
  *
@@ -38,7 +448,43 @@ Pose getPose(bool radians = false);
  */
 void setPose(Pose pose, bool radians = false);
 /**
- * @brief Update the pose of the robot
+ * @brief Set the filter used to estimate velocity and acceleration
+ *
+ * @param settings the filter settings
+ */
+void setVelocityFilter(FilterSettings_t settings);
+/**
+ * @brief Get the velocity of the robot
+ *
+ * @param local true for the robot frame (x to the right, y forwards), false for the field frame. False by default
+ * @param radians true for angular velocity in radians per second, false for degrees per second. False by default
+ * @return Pose velocity in inches per second
+ */
+Pose getVelocity(bool local = false, bool radians = false);
+/**
+ * @brief Get the acceleration of the robot
+ *
+ * @param local true for the robot frame (x to the right, y forwards), false for the field frame. False by default
+ * @param radians true for angular acceleration in radians per second squared, false for degrees. False by default
+ * @return Pose acceleration in inches per second squared
+ */
+Pose getAcceleration(bool local = false, bool radians = false);
+/**
+ * @brief Get the most recent sensor snapshot used by odometry
+ *
+ * The sensors are only read by the tracking task, once per tick, so this never reads a device
+ *
+ * @return SensorSnapshot_t
+ */
+SensorSnapshot_t getSensorSnapshot();
+/**
+ * @brief Update the primary estimator and every added estimator using a sensor snapshot
+ *
+ * @param snapshot the sensor readings for this tick
+ */
+void update(const SensorSnapshot_t& snapshot);
+/**
+ * @brief Sample the sensors and update every estimator
  *
  */
 void update();
@@ -0,0 +1,127 @@
+/**
+ * @file include/lemlib/chassis/recorder.hpp
+ * @author LemLib Team
+ * @brief Odometry input recording and replay declarations
+ * @version 0.4.5
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include "lemlib/chassis/chassis.hpp"
+#include "lemlib/chassis/odom.hpp"
+
+namespace lemlib {
+/**
+ * @brief Format version of the recordings written by this version of LemLib
+ *
+ */
+constexpr std::uint16_t RECORDING_VERSION = 5;
+
+/**
+ * @brief Header at the start of every odometry recording
+ *
+ * The header is followed by packed OdomRecord_t records, one per odometry tick
+ *
+ * @param magic always "LLOR"
+ * @param version format version, RECORDING_VERSION
+ * @param recordSize size of each record in bytes
+ */
+typedef struct {
+        char magic[4];
+        std::uint16_t version;
+        std::uint16_t recordSize;
+} RecordingHeader_t;
+
+/**
+ * @brief The raw odometry inputs of one tick, as recorded
+ *
+ * Only what the sensors read is recorded. Velocities and filtered values are recalculated when the recording is
+ * replayed, so a record is less than half the size of a SensorSnapshot_t
+ *
+ * @param time time the sensors were read, in milliseconds
+ * @param vertical1 distance traveled by the first vertical tracking wheel in inches
+ * @param vertical2 distance traveled by the second vertical tracking wheel in inches
+ * @param horizontal1 distance traveled by the first horizontal tracking wheel in inches
+ * @param horizontal2 distance traveled by the second horizontal tracking wheel in inches
+ * @param leftDrive distance traveled by the left side of the drivetrain in inches
+ * @param rightDrive distance traveled by the right side of the drivetrain in inches
+ * @param imu rotation of the IMU in radians. Fused rotation of all the IMUs if there are several
+ * @param imuAccel horizontal acceleration measured by the IMU in g
+ */
+typedef struct {
+        std::uint32_t time;
+        float vertical1;
+        float vertical2;
+        float horizontal1;
+        float horizontal2;
+        float leftDrive;
+        float rightDrive;
+        float imu;
+        float imuAccel;
+} OdomRecord_t;
+
+/**
+ * @brief Convert a record back to a sensor snapshot
+ *
+ * The velocity of each tracking wheel is the change in its distance since the previous record, so it is noisier than
+ * the filtered velocity odometry saw on the robot
+ *
+ * @param record the record
+ * @param prevRecord the record of the previous tick. The record itself if it is the first
+ * @return SensorSnapshot_t the sensor readings
+ */
+SensorSnapshot_t toSnapshot(const OdomRecord_t& record, const OdomRecord_t& prevRecord);
+/**
+ * @brief Start recording the odometry inputs of every tick to a file
+ *
+ * Records are queued from the tracking task and written to the file by a low priority task, so recording never
+ * blocks odometry. If the queue is full the record is dropped
+ *
+ * @param filePath file path to the recording. No need to preface it with /usd/
+ * @return true if the recording started, false if a recording is still being written or the file couldn't be opened
+ */
+bool startRecording(const char* filePath);
+/**
+ * @brief Stop recording. Queued records are still written before the file is closed
+ *
+ */
+void stopRecording();
+/**
+ * @brief Queue the raw inputs of a sensor snapshot to be recorded. Does nothing if not recording
+ *
+ * Called by odometry every tick
+ *
+ * @param snapshot the sensor readings
+ */
+void record(const SensorSnapshot_t& snapshot);
+/**
+ * @brief Get the number of records dropped because the queue was full or the file couldn't be written
+ *
+ * @return int
+ */
+int getDroppedRecords();
+/**
+ * @brief Feed a recording through an estimator as fast as possible
+ *
+ * @param filePath file path to the recording. No need to preface it with /usd/
+ * @param estimator the estimator to update
+ * @return int the number of records replayed, or -1 if the file couldn't be read
+ */
+int replay(const char* filePath, Odometry& estimator);
+/**
+ * @brief Feed a recording through an estimator as fast as possible
+ *
+ * Works with any file, so recordings can be replayed on a computer. See tools/host
+ *
+ * @param file the recording, opened for reading in binary mode. Not closed
+ * @param estimator the estimator to update
+ * @return int the number of records replayed, or -1 if the file isn't a recording
+ */
+int replay(std::FILE* file, Odometry& estimator);
+} // namespace lemlib
@@ -0,0 +1,97 @@
+/**
+ * @file include/lemlib/chassis/relocalize.hpp
+ * @author LemLib Team
+ * @brief Distance sensor wall relocalization declarations
+ * @version 0.4.5
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#pragma once
+
+#include <vector>
+#include "pros/distance.hpp"
+
+namespace lemlib {
+class Odometry;
+
+/**
+ * @brief Struct containing a distance sensor and where it is mounted
+ *
+ * @param sensor pointer to the distance sensor
+ * @param x offset of the sensor to the right of the tracking center in inches
+ * @param y offset of the sensor in front of the tracking center in inches
+ * @param angle direction the sensor faces relative to the front of the robot in degrees, clockwise positive
+ */
+typedef struct {
+        pros::Distance* sensor;
+        float x;
+        float y;
+        float angle;
+} DistanceSensor_t;
+
+/**
+ * @brief Struct containing the settings for wall relocalization
+ *
+ * The field is assumed to be a square centered on the origin
+ *
+ * @param fieldSize distance between opposite field walls in inches
+ * @param maxResidual largest difference in inches between the measured and expected distance that is trusted.
+ * Larger differences usually mean the sensor sees a robot or game element instead of the wall
+ * @param maxIncidence largest angle in degrees between the sensor and the normal of the wall it sees
+ * @param minConfidence lowest distance sensor confidence that is trusted (0 to 63)
+ * @param maxDistance longest distance reading in inches that is trusted
+ */
+typedef struct {
+        float fieldSize;
+        float maxResidual;
+        float maxIncidence;
+        int minConfidence;
+        float maxDistance;
+} RelocalizeSettings_t;
+
+/**
+ * @brief Corrects the x and y of odometry using distance sensors pointed at the field walls
+ *
+ * The direction and mount offset of each sensor in the field frame is precomputed for every degree of heading, so a
+ * correction only needs table lookups and no trigonometry
+ */
+class WallRelocalizer {
+    public:
+        /**
+         * @brief Construct a new Wall Relocalizer
+         *
+         * @param sensors the distance sensors and where they are mounted
+         * @param settings the relocalization settings
+         */
+        WallRelocalizer(std::vector<DistanceSensor_t> sensors,
+                        RelocalizeSettings_t settings = {140.4, 4, 30, 40, 70});
+        /**
+         * @brief Correct the pose of an estimator once
+         *
+         * The correction is blended into the pose over the next few ticks, so running motions don't see a jump.
+         * Sensors that can't be trusted are ignored
+         *
+         * @param odometry the estimator to correct
+         * @return true if at least one sensor was used for a correction
+         */
+        bool relocalize(Odometry& odometry);
+    private:
+        static constexpr int BINS = 360;
+
+        typedef struct {
+                float directionX;
+                float directionY;
+                float offsetX;
+                float offsetY;
+        } RayEntry_t;
+
+        std::vector<DistanceSensor_t> sensors;
+        RelocalizeSettings_t settings;
+        // BINS + 1 entries per sensor, indexed by heading in degrees
+        std::vector<RayEntry_t> table;
+        float minNormal; // cosine of maxIncidence
+};
+} // namespace lemlib
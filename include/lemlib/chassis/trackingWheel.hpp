@@ -11,9 +11,9 @@
 
 #pragma once
 
-#include "pros/motors.hpp"
-#include "pros/adi.hpp"
-#include "pros/rotation.hpp"
+#include <math.h>
+#include <optional>
+#include "lemlib/chassis/encoder.hpp"
 
 namespace lemlib {
 class TrackingWheel {
@@ -45,6 +45,15 @@ class TrackingWheel {
          * @param rpm theoretical maximum rpm of the drivetrain wheels
          */
         TrackingWheel(pros::Motor_Group* motors, float diameter, float distance, float rpm);
+        /**
+         * @brief Create a new tracking wheel
+         *
+         * @param encoder the mock encoder to use
+         * @param diameter diameter of the tracking wheel in inches
+         * @param distance distance between the tracking wheel and the center of rotation in inches
+         * @param gearRatio gear ratio of the tracking wheel, defaults to 1
+         */
+        TrackingWheel(MockEncoder_t* encoder, float diameter, float distance, float gearRatio = 1);
         /**
          * @brief Reset the tracking wheel position to 0
          *
@@ -56,6 +65,18 @@ class TrackingWheel {
          * @return float distance traveled in inches
          */
         float getDistanceTraveled();
+        /**
+         * @brief Update the velocity of the tracking wheel. Called once per odometry tick
+         *
+         * Rotation sensors and motors measure their own velocity, which has less lag than differentiating the
+         * position. Optical shaft encoders don't, so their velocity is the change in the position already read this
+         * tick. Either way the velocity is low-pass filtered once per tick, as suited to the device
+         *
+         * @param position the distance traveled read this tick, in inches
+         * @param dt time since the last tick in seconds. 0 if there was no last tick
+         * @return float velocity in inches per second
+         */
+        float updateVelocity(float position, float dt);
         /**
          * @brief Get the offset of the tracking wheel from the center of rotation
          *
@@ -69,12 +90,27 @@ class TrackingWheel {
          */
         int getType();
     private:
-        float diameter;
+        /**
+         * @brief The kind of device the tracking wheel reads, resolved when it is constructed
+         *
+         */
+        enum class Device { ADI_ENCODER, ROTATION, MOTOR_GROUP, MOCK };
+
         float distance;
-        float rpm;
+        // only the device of the kind read is set. Motor groups are read through an encoder owned by the tracking
+        // wheel, so copies of the tracking wheel each read through their own
+        Device device;
         pros::ADIEncoder* encoder = nullptr;
         pros::Rotation* rotation = nullptr;
-        pros::Motor_Group* motors = nullptr;
-        float gearRatio = 1;
+        std::optional<MotorGroupEncoder> motorGroup;
+        MockEncoder_t* mock = nullptr;
+        float scale = 0; // inches per unit read from the device
+        bool powered = false;
+
+        // velocity filter
+        float velocitySmoothing = 1;
+        float velocity = 0;
+        float prevPosition = 0;
+        bool hasPrevPosition = false;
 };
 } // namespace lemlib
\ No newline at end of file
@@ -0,0 +1,88 @@
+/**
+ * @file include/lemlib/clock.hpp
+ * @author LemLib Team
+ * @brief Clock interface declarations
+ * @version 0.4.5
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#pragma once
+
+#include <cstdint>
+
+namespace lemlib {
+/**
+ * @brief Source of time for anything that waits or times out
+ *
+ * Controllers read the time through a clock instead of calling pros::millis() directly, so they can be stepped with
+ * a ManualClock and tested deterministically without a brain
+ */
+class Clock {
+    public:
+        virtual ~Clock() = default;
+        /**
+         * @brief Get the current time
+         *
+         * @return std::uint32_t time in milliseconds
+         */
+        virtual std::uint32_t millis() = 0;
+};
+
+/**
+ * @brief Clock that reads the time of the brain
+ *
+ */
+class SystemClock : public Clock {
+    public:
+        /**
+         * @brief Get the milliseconds since PROS initialized
+         *
+         * @return std::uint32_t time in milliseconds
+         */
+        std::uint32_t millis() override;
+};
+
+/**
+ * @brief Clock that only moves when told to
+ *
+ */
+class ManualClock : public Clock {
+    public:
+        /**
+         * @brief Construct a new Manual Clock
+         *
+         * @param time the starting time in milliseconds
+         */
+        ManualClock(std::uint32_t time = 0);
+        /**
+         * @brief Get the current time
+         *
+         * @return std::uint32_t time in milliseconds
+         */
+        std::uint32_t millis() override;
+        /**
+         * @brief Set the current time
+         *
+         * @param time the new time in milliseconds
+         */
+        void setTime(std::uint32_t time);
+        /**
+         * @brief Move the current time forwards
+         *
+         * @param dt how far to move the time in milliseconds
+         */
+        void advance(std::uint32_t dt);
+    private:
+        std::uint32_t time;
+};
+
+/**
+ * @brief Get the clock that reads the time of the brain. Used by default
+ *
+ * @return Clock&
+ */
+Clock& getSystemClock();
+} // namespace lemlib
@@ -0,0 +1,112 @@
+/**
+ * @file include/lemlib/filter.hpp
+ * @author LemLib Team
+ * @brief Velocity and acceleration filter declarations
+ * @version 0.4.5
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#pragma once
+
+namespace lemlib {
+/**
+ * @brief The algorithm used by a VelocityFilter
+ *
+ * ALPHA_BETA: alpha-beta-gamma tracker. Cheap and low latency, tuned with alpha, beta and gamma
+ * SAVITZKY_GOLAY: least squares quadratic fit over the last few samples, evaluated at the newest sample
+ */
+enum class FilterType { ALPHA_BETA, SAVITZKY_GOLAY };
+
+/**
+ * @brief Struct containing the settings for a velocity filter
+ *
+ * @param type the algorithm to use
+ * @param alpha position gain of the alpha-beta filter (0 to 1)
+ * @param beta velocity gain of the alpha-beta filter (0 to 2)
+ * @param gamma acceleration gain of the alpha-beta filter. Set 0 to disable acceleration tracking
+ * @param window number of samples used by the Savitzky-Golay filter (3 to 16)
+ */
+typedef struct {
+        FilterType type;
+        float alpha;
+        float beta;
+        float gamma;
+        int window;
+} FilterSettings_t;
+
+/**
+ * @brief Estimates the velocity and acceleration of a signal from position samples
+ *
+ * The filter is updated incrementally, once per sample, and never allocates memory
+ */
+class VelocityFilter {
+    public:
+        /** @brief the largest supported Savitzky-Golay window */
+        static constexpr int MAX_WINDOW = 16;
+        /**
+         * @brief Construct a new Velocity Filter
+         *
+         * @param settings the filter settings
+         */
+        VelocityFilter(FilterSettings_t settings = {FilterType::ALPHA_BETA, 0.5, 0.17, 0.03, 7});
+        /**
+         * @brief Add a new position sample
+         *
+         * @param position the new position
+         * @param dt time since the last sample in seconds
+         */
+        void update(float position, float dt);
+        /**
+         * @brief Add a new position sample along with a measured velocity
+         *
+         * The velocity estimate filters the measured velocity instead of differentiating the position, so it has
+         * less lag and noise. The alpha-beta filter uses alpha as the velocity gain and beta as the acceleration gain.
+         * The Savitzky-Golay filter fits the velocity samples. Switching between the two kinds of sample resets the
+         * filter
+         *
+         * @param position the new position
+         * @param velocity the measured velocity
+         * @param dt time since the last sample in seconds
+         */
+        void update(float position, float velocity, float dt);
+        /**
+         * @brief Reset the filter to a stationary state
+         *
+         * @param position the current position
+         */
+        void reset(float position = 0);
+        /**
+         * @brief Get the estimated velocity
+         *
+         * @return float units per second
+         */
+        float getVelocity();
+        /**
+         * @brief Get the estimated acceleration
+         *
+         * @return float units per second squared
+         */
+        float getAcceleration();
+    private:
+        FilterSettings_t settings;
+        bool initialized = false;
+        bool measured = false; // whether the samples are measured velocities
+
+        // alpha-beta state
+        float position = 0;
+        float velocity = 0;
+        float acceleration = 0;
+
+        // Savitzky-Golay state
+        float samples[MAX_WINDOW] = {0};
+        float valueWeights[MAX_WINDOW] = {0};
+        float velocityWeights[MAX_WINDOW] = {0};
+        float accelerationWeights[MAX_WINDOW] = {0};
+        int head = 0;
+        int count = 0;
+        float dts[MAX_WINDOW] = {0};
+};
+} // namespace lemlib
@@ -0,0 +1,76 @@
+/**
+ * @file include/lemlib/gainSchedule.hpp
+ * @author LemLib Team
+ * @brief Gain schedule declarations
+ * @version 0.4.5
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#pragma once
+
+#include <vector>
+
+namespace lemlib {
+/**
+ * @brief What a gain schedule is keyed on
+ *
+ * ERROR: the magnitude of the error
+ * SPEED: the magnitude of the change in error, per second
+ */
+enum class ScheduleKey { ERROR, SPEED };
+
+/**
+ * @brief Struct containing one point of a gain schedule
+ *
+ * @param key the error or speed magnitude at this point
+ * @param pScale what kP is multiplied by at this point
+ * @param dScale what kD is multiplied by at this point
+ */
+typedef struct {
+        float key;
+        float pScale;
+        float dScale;
+} GainPoint_t;
+
+/**
+ * @brief Piecewise-linear scaling of FAPID gains
+ *
+ * The points are resampled into a uniform lookup table once, when the schedule is created, so looking up the scales
+ * costs the same no matter how many points there are. Keys below the first point use the first point, and keys past
+ * the last point use the last point
+ */
+class GainSchedule {
+    public:
+        static constexpr int RESOLUTION = 64;
+        /**
+         * @brief Construct a new Gain Schedule
+         *
+         * @param points the points of the schedule. Sorted by key automatically
+         * @param key what the schedule is keyed on. ERROR by default
+         */
+        GainSchedule(std::vector<GainPoint_t> points, ScheduleKey key = ScheduleKey::ERROR);
+        /**
+         * @brief Look up the gain scales
+         *
+         * @param key the error or speed. Only the magnitude is used
+         * @param pScale set to what kP should be multiplied by
+         * @param dScale set to what kD should be multiplied by
+         */
+        void lookup(float key, float& pScale, float& dScale) const;
+        /**
+         * @brief Get what the schedule is keyed on
+         *
+         * @return ScheduleKey
+         */
+        ScheduleKey getKey() const;
+    private:
+        ScheduleKey key;
+        float keysPerEntry = 1;
+        float entriesPerKey = 0; // 0 if every key gives the same scales
+        float pTable[RESOLUTION + 1];
+        float dTable[RESOLUTION + 1];
+};
+} // namespace lemlib
@@ -11,17 +11,27 @@
 
 #pragma once
 
-namespace lemlib {
-
-static bool debug = false;
-static bool verbose = false;
+/**
+ * @brief The lowest level that is compiled in, as the number of a lemlib::logger::Level (0 for DEBUG to 4 for
+ * FATAL). Calls below it made through the LEMLIB_DEBUG, LEMLIB_INFO etc. macros are removed entirely, including
+ * the evaluation of their arguments. Define it before including LemLib, or with -DLEMLIB_LOG_LEVEL=2 in the
+ * Makefile, to change it
+ *
+ * It only affects the files compiled with it, which is your own code. The log calls inside LemLib were compiled
+ * into the library already, and are still filtered at runtime by setLowestLevel(), setDebug() and setVerbose()
+ *
+ */
+#ifndef LEMLIB_LOG_LEVEL
+#define LEMLIB_LOG_LEVEL 0
+#endif
 
+namespace lemlib {
 namespace logger {
 
 /**
  * @brief A level enumeration.
  *
- * Debug: Only enabled if lemlib::logger::debug is true
+ * Debug: Only enabled if lemlib::logger::setDebug(true) was called
  * Info: General information
  * Warn: Warnings, usually not critical/doesn't affect the robot
  * Error: Errors, usually critical and affects the robot
@@ -31,7 +41,15 @@ namespace logger {
  */
 enum class Level { DEBUG, INFO, WARN, ERROR, FATAL };
 
-static Level lowestLevel = Level::INFO;
+/**
+ * @brief Whether a message of a level would be logged with the current configuration
+ *
+ * Checks the compile time level, the lowest level, and the debug and verbose flags
+ *
+ * @param level the level of the message
+ * @return true if the message would be logged
+ */
+bool isEnabled(Level level);
 
 /**
  * @brief Whether or not to log debug messages.
@@ -40,7 +58,7 @@ static Level lowestLevel = Level::INFO;
  */
 bool isDebug();
 /**
- * @brief Sets lemlib::debug
+ * @brief Sets whether debug messages are logged. Shared by every file
  *
  * @param debug the new value
  */
@@ -54,7 +72,7 @@ void setDebug(bool debug);
  */
 bool isVerbose();
 /**
- * @brief Sets lemlib::verbose
+ * @brief Sets whether info messages are logged. Shared by every file
  *
  * @param verbose the new value
  */
@@ -68,12 +86,23 @@ void setVerbose(bool verbose);
 Level getLowestLevel();
 
 /**
- * @brief Sets the lowest loggable level
+ * @brief Sets the lowest loggable level. Shared by every file
  *
  * @param level the new lowest loggable level
  */
 void setLowestLevel(Level level);
 
+/**
+ * @brief Get the number of messages dropped because the log buffer was full
+ *
+ * Messages are queued and printed by a low priority task, so logging never blocks the caller. If messages are
+ * logged faster than they can be printed, the newest ones are dropped. Fatal messages are never queued, they are
+ * printed and flushed before the log call returns
+ *
+ * @return int
+ */
+int getDroppedMessages();
+
 /**
  * @brief Logs a message with an exception
  *
@@ -90,6 +119,17 @@ void log(Level level, const char* message, const char* exception);
  */
 void log(Level level, const char* message);
 
+/**
+ * @brief Logs a message formatted like printf
+ *
+ * Prefer the LEMLIB_DEBUG, LEMLIB_INFO etc. macros, which skip formatting the message and evaluating the arguments
+ * when the level is disabled
+ *
+ * @param level the level of the message
+ * @param format the printf format of the message
+ */
+void logf(Level level, const char* format, ...) __attribute__((format(printf, 2, 3)));
+
 /**
  * @brief Logs a debug message
  *
@@ -136,4 +176,40 @@ void fatal(const char* message, const char* exception);
 void fatal(const char* message);
 
 } // namespace logger
-} // namespace lemlib
\ No newline at end of file
+} // namespace lemlib
+
+/**
+ * @brief Log a message formatted like printf, if the level is enabled. The arguments are only evaluated if the
+ * message is logged
+ *
+ */
+#define LEMLIB_LOG(level, ...)                                                                                         \
+    do {                                                                                                               \
+        if (lemlib::logger::isEnabled(level)) lemlib::logger::logf(level, __VA_ARGS__);                                \
+    } while (0)
+
+#if LEMLIB_LOG_LEVEL <= 0
+#define LEMLIB_DEBUG(...) LEMLIB_LOG(lemlib::logger::Level::DEBUG, __VA_ARGS__)
+#else
+#define LEMLIB_DEBUG(...) ((void)0)
+#endif
+
+#if LEMLIB_LOG_LEVEL <= 1
+#define LEMLIB_INFO(...) LEMLIB_LOG(lemlib::logger::Level::INFO, __VA_ARGS__)
+#else
+#define LEMLIB_INFO(...) ((void)0)
+#endif
+
+#if LEMLIB_LOG_LEVEL <= 2
+#define LEMLIB_WARN(...) LEMLIB_LOG(lemlib::logger::Level::WARN, __VA_ARGS__)
+#else
+#define LEMLIB_WARN(...) ((void)0)
+#endif
+
+#if LEMLIB_LOG_LEVEL <= 3
+#define LEMLIB_ERROR(...) LEMLIB_LOG(lemlib::logger::Level::ERROR, __VA_ARGS__)
+#else
+#define LEMLIB_ERROR(...) ((void)0)
+#endif
+
+#define LEMLIB_FATAL(...) LEMLIB_LOG(lemlib::logger::Level::FATAL, __VA_ARGS__)
\ No newline at end of file
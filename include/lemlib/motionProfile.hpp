@@ -0,0 +1,89 @@
+/**
+ * @file include/lemlib/motionProfile.hpp
+ * @author LemLib Team
+ * @brief Motion profile declarations
+ * @version 0.4.5
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#pragma once
+
+namespace lemlib {
+/**
+ * @brief The shape of the velocity of a motion profile
+ *
+ * TRAPEZOIDAL: constant acceleration up to the cruise velocity, then constant deceleration
+ * S_CURVE: acceleration rises and falls smoothly (as a half sine), so there are no jumps in acceleration. Takes
+ * slightly longer than TRAPEZOIDAL for the same maximum acceleration
+ */
+enum class ProfileShape { TRAPEZOIDAL, S_CURVE };
+
+/**
+ * @brief Struct containing the limits of a motion profile
+ *
+ * @param maxVelocity the largest velocity, in units per second
+ * @param maxAcceleration the largest acceleration, in units per second squared
+ */
+typedef struct {
+        float maxVelocity;
+        float maxAcceleration;
+} ProfileConstraints_t;
+
+/**
+ * @brief Struct containing the state of a motion profile at a point in time
+ *
+ * @param position distance from the start, in units
+ * @param velocity in units per second
+ * @param acceleration in units per second squared
+ */
+typedef struct {
+        float position;
+        float velocity;
+        float acceleration;
+} ProfileState_t;
+
+/**
+ * @brief Motion profile over a distance, starting and ending at rest
+ *
+ * The profile is solved in closed form when it is created, so sampling it costs the same at any time
+ */
+class MotionProfile {
+    public:
+        /**
+         * @brief Construct a new Motion Profile
+         *
+         * If the distance is too short to reach the maximum velocity, the profile peaks at a lower velocity
+         *
+         * @param distance the distance to travel. Can be negative
+         * @param constraints the velocity and acceleration limits
+         * @param shape the shape of the profile
+         */
+        MotionProfile(float distance, ProfileConstraints_t constraints, ProfileShape shape);
+        /**
+         * @brief Get the state of the profile at a point in time
+         *
+         * @param t time since the start of the profile in seconds. Times past the end give the final state
+         * @return ProfileState_t
+         */
+        ProfileState_t sample(float t);
+        /**
+         * @brief Get how long the profile takes
+         *
+         * @return float duration in seconds
+         */
+        float getDuration();
+    private:
+        ProfileState_t ramp(float t);
+
+        ProfileShape shape;
+        float sign = 1;
+        float distance = 0; // magnitude of the distance
+        float peakVelocity = 0;
+        float accelTime = 0;
+        float cruiseTime = 0;
+        float duration = 0;
+};
+} // namespace lemlib
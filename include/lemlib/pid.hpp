@@ -9,8 +9,12 @@
  *
  */
 #pragma once
+#include <atomic>
 #include <string>
 #include "pros/rtos.hpp"
+#include "lemlib/clock.hpp"
+#include "lemlib/gainSchedule.hpp"
+#include "lemlib/ringBuffer.hpp"
 
 namespace lemlib {
 /**
@@ -33,6 +37,24 @@ class FAPID {
          * @param name name of the FAPID. Used for logging
          */
         FAPID(float kF, float kA, float kP, float kI, float kD, std::string name);
+        /**
+         * @brief Copy a FAPID. The copy can be tuned separately, under the same name
+         *
+         * @param other the FAPID to copy
+         */
+        FAPID(const FAPID& other);
+        /**
+         * @brief Copy the gains and state of another FAPID
+         *
+         * @param other the FAPID to copy
+         * @return FAPID&
+         */
+        FAPID& operator=(const FAPID& other);
+        /**
+         * @brief Destroy the FAPID
+         *
+         */
+        ~FAPID();
         /**
          * @brief Set gains
          *
@@ -43,6 +65,30 @@ class FAPID {
          * @param kD derivative gain, multiplied by change in error and added to output
          */
         void setGains(float kF, float kA, float kP, float kI, float kD);
+        /**
+         * @brief Set a gain schedule, which scales kP and kD every update
+         *
+         * @param schedule the schedule to use, or nullptr for none. Must stay alive while it is set
+         */
+        void setSchedule(const GainSchedule* schedule);
+        /**
+         * @brief Set the integral anti-windup
+         *
+         * @param maxIntegral largest output the integral term can contribute. 0 for no limit, which is the default
+         * @param resetOnSignChange whether to reset the integral when the error crosses 0. False by default
+         */
+        void setIntegral(float maxIntegral, bool resetOnSignChange = false);
+        /**
+         * @brief Set the derivative low-pass filter and what the derivative is taken of
+         *
+         * Taking the derivative of the position instead of the error stops the derivative term from spiking when the
+         * target changes
+         *
+         * @param timeConstantMs time constant of the low-pass filter in milliseconds. 0 for no filtering, which is the
+         * default
+         * @param onMeasurement true to take the derivative of the position instead of the error. False by default
+         */
+        void setDerivative(float timeConstantMs, bool onMeasurement = false);
         /**
          * @brief Set the exit conditions
          *
@@ -53,16 +99,41 @@ class FAPID {
          * @param maxTime
          */
         void setExit(float largeError, float smallError, int largeTime, int smallTime, int maxTime);
+        /**
+         * @brief Set a velocity based exit condition
+         *
+         * The FAPID is settled as soon as the error and the rate of change of the error are both small, without
+         * waiting for the exit timers. The rate is measured by the derivative, so it is filtered if a derivative
+         * filter is set
+         *
+         * @param maxError largest error the FAPID can settle at
+         * @param maxSpeed largest change in error per second the FAPID can settle at. 0 to disable, which is the
+         * default
+         */
+        void setVelocityExit(float maxError, float maxSpeed);
         /**
          * @brief Update the FAPID
          *
          * @param target the target value
          * @param position the current value
-         * @param log whether to check the most recent terminal input for user input. Default is false because logging
-         * multiple PIDs could slow down the program.
+         * @param log whether to apply gain changes made through the terminal. Checking never blocks
          * @return float - output
          */
         float update(float target, float position, bool log = false);
+        /**
+         * @brief Update the FAPID with the time since the last update
+         *
+         * Named apart from update() so an int or double dt, or a bool log flag, always selects the intended function.
+         * The integral is accumulated per 10 milliseconds and the derivative is measured per 10 milliseconds, so gains
+         * tuned for the default 10ms loop stay the same at any loop rate. The acceleration limit is scaled the same way
+         *
+         * @param target the target value
+         * @param position the current value
+         * @param dtMs time since the last update in milliseconds
+         * @param log whether to apply gain changes made through the terminal. Checking never blocks
+         * @return float - output
+         */
+        float updateDt(float target, float position, float dtMs, bool log = false);
         /**
          * @brief Reset the FAPID
          */
@@ -76,11 +147,21 @@ class FAPID {
          * @return false - the FAPID has not settled
          */
         bool settled();
+        /**
+         * @brief Set the clock used by settled()
+         *
+         * @param clock the clock to use. Must stay alive while the FAPID is used. The system clock by default
+         */
+        void setClock(Clock& clock);
         /**
          * @brief initialize the FAPID logging system
          *
          * if this function is called, std::cin will be used to interact with the FAPID
          *
+         * Commands are read and parsed by a separate task. Gain changes are queued for each FAPID with a matching
+         * name, and applied the next time it updates with logging enabled, so the control loop never waits on the
+         * terminal
+         *
          * the user can interact with the FAPID through the terminal
          * the user can access gains and other variables with the following format:
          * <name>.<variable> to get the value of the variable
@@ -107,19 +188,43 @@ class FAPID {
         int largeTime = 0;
         int smallTime = 0;
         int maxTime = -1; // -1 means no max time set, run forever
+        float settleError = 0;
+        float settleSpeed = 0; // 0 means no velocity exit
+
+        // -1 means the timer hasn't started
+        int largeTimeCounter = -1;
+        int smallTimeCounter = -1;
+        int startTime = -1;
+        Clock* clock = &getSystemClock();
+        const GainSchedule* schedule = nullptr;
 
-        int largeTimeCounter = 0;
-        int smallTimeCounter = 0;
-        int startTime = 0;
+        float maxIntegral = 0; // 0 means no limit
+        bool integralSignReset = false;
+        float derivativeTimeConstant = 0; // milliseconds, 0 means no filtering
+        bool derivativeOnMeasurement = false;
 
         float prevError = 0;
         float totalError = 0;
         float prevOutput = 0;
+        float prevDeltaError = 0;
+        float prevPosition = 0;
+        bool hasPrevPosition = false;
+
+        enum class Command { SET_KF, SET_KA, SET_KP, SET_KI, SET_KD, RESET };
+
+        typedef struct {
+                Command command;
+                float value;
+        } TuningCommand_t;
 
         void log();
+        void mirror();
+        static void readCommands();
         std::string name;
-        static std::string input;
+        // commands from the terminal task, applied by the task running the controller
+        RingBuffer<TuningCommand_t, 8> commands;
+        // copies of kF, kA, kP, kI, kD and totalError that the terminal task can read at any time
+        std::atomic<float> mirrored[6];
         static pros::Task* logTask;
-        static pros::Mutex logMutex;
 };
 } // namespace lemlib
@@ -0,0 +1,130 @@
+/**
+ * @file include/lemlib/pidBank.hpp
+ * @author LemLib Team
+ * @brief PIDBank class declarations
+ * @version 0.4.5
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#pragma once
+
+#include <string>
+
+namespace lemlib {
+/**
+ * @brief A group of FAPID-style controllers updated together
+ *
+ * The gains and state of every controller are stored in arrays, one per variable, and every controller is updated in
+ * a single pass without branches. On the brain the pass uses NEON to update 4 controllers at a time. Names are only
+ * used to register and find controllers, which are then referred to by id.
+ *
+ * For example:
+ * int lift = bank.add("lift", 0, 0, 2, 0, 10);
+ * bank.setTarget(lift, 500);
+ * while (true) { bank.setPosition(lift, liftMotor.get_position()); bank.update(); liftMotor.move(bank.getOutput(lift));
+ * pros::delay(10); }
+ */
+class PIDBank {
+    public:
+        static constexpr int CAPACITY = 16;
+        /**
+         * @brief Add a controller
+         *
+         * @param name name of the controller, used to find it later
+         * @param kF feedfoward gain, multiplied by target and added to output. Set 0 if disabled
+         * @param kA acceleration gain, limits the change in output per 10ms. Set 0 if disabled
+         * @param kP proportional gain, multiplied by error and added to output
+         * @param kI integral gain, multiplied by total error and added to output
+         * @param kD derivative gain, multiplied by change in error and added to output
+         * @return int id of the controller, or -1 if the bank is full
+         */
+        int add(const std::string& name, float kF, float kA, float kP, float kI, float kD);
+        /**
+         * @brief Find a controller by name
+         *
+         * @param name name of the controller
+         * @return int id of the controller, or -1 if there is none with that name
+         */
+        int find(const std::string& name) const;
+        /**
+         * @brief Set the gains of a controller
+         *
+         * @param id id of the controller
+         * @param kF feedfoward gain
+         * @param kA acceleration gain. Set 0 if disabled
+         * @param kP proportional gain
+         * @param kI integral gain
+         * @param kD derivative gain
+         */
+        void setGains(int id, float kF, float kA, float kP, float kI, float kD);
+        /**
+         * @brief Limit the output the integral term of a controller can contribute
+         *
+         * @param id id of the controller
+         * @param maxIntegral largest output of the integral term. 0 for no limit
+         */
+        void setIntegralLimit(int id, float maxIntegral);
+        /**
+         * @brief Set the target of a controller
+         *
+         * @param id id of the controller
+         * @param target the target value
+         */
+        void setTarget(int id, float target);
+        /**
+         * @brief Set the current value of a controller
+         *
+         * @param id id of the controller
+         * @param position the current value
+         */
+        void setPosition(int id, float position);
+        /**
+         * @brief Update every controller
+         *
+         * @param dtMs time since the last update in milliseconds. Gains are tuned for 10ms, like FAPID
+         */
+        void update(float dtMs = 10);
+        /**
+         * @brief Get the output of a controller from the last update
+         *
+         * @param id id of the controller
+         * @return float output
+         */
+        float getOutput(int id) const;
+        /**
+         * @brief Reset the state of a controller
+         *
+         * @param id id of the controller
+         */
+        void reset(int id);
+        /**
+         * @brief Get the number of controllers
+         *
+         * @return int
+         */
+        int size() const;
+    private:
+        bool valid(int id) const;
+        void updateLimits(int id);
+
+        int count = 0;
+        std::string names[CAPACITY];
+        float maxIntegrals[CAPACITY] = {};
+
+        // everything read by update(). Unused slots are 0, so they always output 0
+        alignas(16) float kF[CAPACITY] = {};
+        alignas(16) float kP[CAPACITY] = {};
+        alignas(16) float kI[CAPACITY] = {};
+        alignas(16) float kD[CAPACITY] = {};
+        alignas(16) float slewLimit[CAPACITY] = {}; // largest change in output per 10ms, infinite if kA is 0
+        alignas(16) float integralLimit[CAPACITY] = {}; // largest total error, infinite if there is no limit
+        alignas(16) float target[CAPACITY] = {};
+        alignas(16) float position[CAPACITY] = {};
+        alignas(16) float prevError[CAPACITY] = {};
+        alignas(16) float totalError[CAPACITY] = {};
+        alignas(16) float output[CAPACITY] = {};
+};
+} // namespace lemlib
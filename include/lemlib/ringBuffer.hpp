@@ -0,0 +1,142 @@
+/**
+ * @file include/lemlib/ringBuffer.hpp
+ * @author LemLib Team
+ * @brief Lock-free ring buffers for passing data between tasks
+ * @version 0.4.5
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+
+namespace lemlib {
+/**
+ * @brief Fixed-capacity, lock-free ring buffer for passing data from one task to another
+ *
+ * Exactly one task may push and exactly one task may pop. Neither side ever blocks or allocates memory, so it is safe
+ * to push from a control loop.
+ *
+ * @tparam T the type of the elements
+ * @tparam Size the number of slots. Must be a power of 2. One slot is always left empty
+ */
+template <typename T, std::size_t Size> class RingBuffer {
+        static_assert(Size >= 2 && (Size & (Size - 1)) == 0, "RingBuffer size must be a power of 2");
+    public:
+        /**
+         * @brief Add an element to the buffer. Only call from the producer task
+         *
+         * @param value the element to add
+         * @return true if the element was added, false if the buffer is full
+         */
+        bool push(const T& value) {
+            std::size_t head = this->head.load(std::memory_order_relaxed);
+            std::size_t next = (head + 1) & (Size - 1);
+            if (next == tail.load(std::memory_order_acquire)) return false;
+            data[head] = value;
+            this->head.store(next, std::memory_order_release);
+            return true;
+        }
+
+        /**
+         * @brief Remove the oldest element from the buffer. Only call from the consumer task
+         *
+         * @param value where to store the element
+         * @return true if an element was removed, false if the buffer is empty
+         */
+        bool pop(T& value) {
+            std::size_t tail = this->tail.load(std::memory_order_relaxed);
+            if (tail == head.load(std::memory_order_acquire)) return false;
+            value = data[tail];
+            this->tail.store((tail + 1) & (Size - 1), std::memory_order_release);
+            return true;
+        }
+
+        /**
+         * @brief Whether the buffer is empty. Safe to call from either task
+         *
+         * @return true if the buffer is empty
+         */
+        bool empty() const { return head.load(std::memory_order_acquire) == tail.load(std::memory_order_acquire); }
+    private:
+        T data[Size];
+        std::atomic<std::size_t> head {0};
+        std::atomic<std::size_t> tail {0};
+};
+
+/**
+ * @brief Fixed-capacity, lock-free ring buffer for passing data from several tasks to one task
+ *
+ * Any number of tasks may push, and exactly one task may pop. Each slot has a sequence number that says whether it
+ * is free for the current lap of the producers or holds an element for the current lap of the consumer, so producers
+ * only contend on claiming a slot and never block each other while copying.
+ *
+ * @tparam T the type of the elements
+ * @tparam Size the number of slots. Must be a power of 2
+ */
+template <typename T, std::size_t Size> class MPSCRingBuffer {
+        static_assert(Size >= 2 && (Size & (Size - 1)) == 0, "MPSCRingBuffer size must be a power of 2");
+    public:
+        MPSCRingBuffer() {
+            for (std::size_t i = 0; i < Size; i++) slots[i].sequence.store(i, std::memory_order_relaxed);
+        }
+
+        /**
+         * @brief Add an element to the buffer. Safe to call from any task
+         *
+         * @param value the element to add
+         * @return true if the element was added, false if the buffer is full
+         */
+        bool push(const T& value) {
+            std::size_t position = head.load(std::memory_order_relaxed);
+            while (true) {
+                Slot& slot = slots[position & (Size - 1)];
+                std::size_t sequence = slot.sequence.load(std::memory_order_acquire);
+                std::ptrdiff_t difference = std::ptrdiff_t(sequence) - std::ptrdiff_t(position);
+                if (difference == 0) {
+                    // the slot is free, try to claim it. On failure position is updated to the new head
+                    if (head.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                        slot.value = value;
+                        slot.sequence.store(position + 1, std::memory_order_release);
+                        return true;
+                    }
+                } else if (difference < 0) {
+                    // the slot still holds an element from the previous lap
+                    return false;
+                } else {
+                    // another producer claimed the slot first
+                    position = head.load(std::memory_order_relaxed);
+                }
+            }
+        }
+
+        /**
+         * @brief Remove the oldest element from the buffer. Only call from the consumer task
+         *
+         * @param value where to store the element
+         * @return true if an element was removed, false if the buffer is empty or the oldest element is still being
+         * written
+         */
+        bool pop(T& value) {
+            Slot& slot = slots[tail & (Size - 1)];
+            if (slot.sequence.load(std::memory_order_acquire) != tail + 1) return false;
+            value = slot.value;
+            slot.sequence.store(tail + Size, std::memory_order_release);
+            tail++;
+            return true;
+        }
+    private:
+        struct Slot {
+                std::atomic<std::size_t> sequence;
+                T value;
+        };
+
+        Slot slots[Size];
+        std::atomic<std::size_t> head {0};
+        std::size_t tail = 0;
+};
+} // namespace lemlib
@@ -0,0 +1,93 @@
+/**
+ * @file include/lemlib/telemetry.hpp
+ * @author LemLib Team
+ * @brief Binary telemetry stream declarations
+ * @version 0.4.5
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#pragma once
+
+#include <cstdint>
+
+namespace lemlib {
+namespace telemetry {
+/**
+ * @brief The type of the values of a channel
+ *
+ */
+enum class ChannelType : std::uint8_t { FLOAT = 0, INT = 1 };
+
+/**
+ * @brief The kind of a telemetry frame, stored in its first byte
+ *
+ * CHANNEL: [id u8][type u8][name], sent when a channel is added and once a second after that, so a decoder that
+ * starts late still learns every channel
+ * SAMPLES: [time u32 ms][count u8], then count samples of [channel u8][time offset u8 ms][value 4 bytes]
+ *
+ * Every frame ends with a CRC-16/CCITT-FALSE of the rest of the frame, is COBS encoded, and has a 0 byte before and
+ * after it. All values are little endian. tools/telemetry_decode.py decodes the stream to CSV
+ *
+ * A full frame costs about 6.3 bytes per value, roughly 7 times less than a line of text from the logger
+ */
+enum class FrameKind : std::uint8_t { CHANNEL = 1, SAMPLES = 2 };
+
+constexpr int MAX_CHANNELS = 32;
+constexpr int MAX_NAME_LENGTH = 23;
+
+/**
+ * @brief Add a channel. Channels are added once, usually in initialize()
+ *
+ * @param name the name of the channel. Truncated to MAX_NAME_LENGTH characters
+ * @param type the type of the values. FLOAT by default
+ * @return int the id of the channel, or -1 if there are already MAX_CHANNELS channels
+ */
+int addChannel(const char* name, ChannelType type = ChannelType::FLOAT);
+/**
+ * @brief Start sending telemetry over the serial port
+ *
+ * The stream multiplexing of the PROS serial driver is disabled so frames reach the computer unchanged. Text printed
+ * by the rest of the program is still sent, and is ignored by the decoder
+ *
+ */
+void start();
+/**
+ * @brief Stop sending telemetry, and restore the stream multiplexing of the PROS serial driver
+ *
+ * Waits for the frame being sent to finish. Samples that haven't been sent yet are dropped, and samples written after
+ * this are ignored
+ *
+ */
+void stop();
+/**
+ * @brief Queue a value of a FLOAT channel to be sent
+ *
+ * Safe to call from any task. The value is timestamped now, and sent by a low priority task. If the queue is full
+ * the value is dropped
+ *
+ * @param channel the id of the channel
+ * @param value the value
+ * @return true if the value was queued, false if telemetry isn't running, the channel isn't a FLOAT channel or the
+ * queue is full
+ */
+bool writeFloat(int channel, float value);
+/**
+ * @brief Queue a value of an INT channel to be sent
+ *
+ * @param channel the id of the channel
+ * @param value the value
+ * @return true if the value was queued, false if telemetry isn't running, the channel isn't an INT channel or the
+ * queue is full
+ */
+bool writeInt(int channel, std::int32_t value);
+/**
+ * @brief Get the number of samples dropped because the queue was full
+ *
+ * @return int
+ */
+int getDroppedSamples();
+} // namespace telemetry
+} // namespace lemlib
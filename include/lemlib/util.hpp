@@ -74,4 +74,13 @@ float avg(std::vector<float> values);
  * @return double
  */
 double avg(std::vector<double> values);
+
+/**
+ * @brief Return the average of an array of numbers
+ *
+ * @param values pointer to the first number
+ * @param count how many numbers there are
+ * @return float
+ */
+float avg(const float* values, int count);
 } // namespace lemlib
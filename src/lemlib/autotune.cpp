@@ -0,0 +1,87 @@
+/**
+ * @file src/lemlib/autotune.cpp
+ * @author LemLib Team
+ * @brief Relay feedback autotuner definitions
+ * @version 0.4.5
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#include <math.h>
+#include "lemlib/autotune.hpp"
+
+/**
+ * @brief Construct a new Relay Autotuner
+ *
+ * @param settings the autotuning settings
+ */
+lemlib::RelayAutotuner::RelayAutotuner(AutotuneSettings_t settings)
+    : settings(settings) {}
+
+/**
+ * @brief Update the relay
+ *
+ * @param error the target value minus the current value
+ * @param timeMs the current time in milliseconds
+ * @return float the output to apply to the system
+ */
+float lemlib::RelayAutotuner::update(float error, std::uint32_t timeMs) {
+    if (isDone()) return 0;
+    // start with the relay pushing towards the target
+    if (output == 0) output = (error >= 0) ? settings.relayAmplitude : -settings.relayAmplitude;
+    maxError = std::fmax(maxError, error);
+    minError = std::fmin(minError, error);
+
+    if (output < 0 && error > settings.hysteresis) {
+        output = settings.relayAmplitude;
+        // a full oscillation ends every time the relay switches high. The first one is still settling, so skip it
+        if (switches >= 2) {
+            amplitudeSum += (maxError - minError) / 2;
+            periodSum += timeMs - lastSwitchTime;
+            measured++;
+        }
+        switches++;
+        lastSwitchTime = timeMs;
+        maxError = error;
+        minError = error;
+    } else if (output > 0 && error < -settings.hysteresis) {
+        output = -settings.relayAmplitude;
+    }
+    return output;
+}
+
+/**
+ * @brief Whether enough oscillations have been measured
+ *
+ * @return true if the result is ready
+ */
+bool lemlib::RelayAutotuner::isDone() { return measured >= settings.cycles; }
+
+/**
+ * @brief Get the result. The gains are 0 if it isn't done
+ *
+ * @return AutotuneResult_t
+ */
+lemlib::AutotuneResult_t lemlib::RelayAutotuner::getResult() {
+    AutotuneResult_t result = {false, 0, 0, 0, 0};
+    if (measured == 0) return result;
+    float amplitude = amplitudeSum / measured;
+    // describing function of a relay with hysteresis
+    float effective = std::sqrt(std::fmax(amplitude * amplitude - settings.hysteresis * settings.hysteresis, 0));
+    if (effective <= 0) return result;
+    result.success = isDone();
+    result.ultimateGain = 4 * settings.relayAmplitude / (M_PI * effective);
+    result.ultimatePeriod = periodSum / measured;
+    // Ziegler-Nichols PD: kP = 0.8Ku, Td = Tu / 8. The FAPID derivative is the change in error per 10ms
+    result.kP = 0.8 * result.ultimateGain;
+    result.kD = result.kP * (result.ultimatePeriod / 8) / 10;
+    return result;
+}
+
+/**
+ * @brief Reset the autotuner, so it can run again
+ *
+ */
+void lemlib::RelayAutotuner::reset() { *this = RelayAutotuner(settings); }
@@ -0,0 +1,117 @@
+/**
+ * @file src/lemlib/characterize.cpp
+ * @author LemLib Team
+ * @brief Drivetrain characterization definitions
+ * @version 0.4.5
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#include <cmath>
+#include <cstdio>
+#include <string>
+#include "lemlib/characterize.hpp"
+
+/**
+ * @brief Add a sample
+ *
+ * @param power the power applied
+ * @param velocity the measured velocity
+ * @param acceleration the measured acceleration
+ */
+void lemlib::FeedforwardFit::addSample(float power, float velocity, float acceleration) {
+    double x[3] = {(velocity < 0) ? -1.0 : 1.0, velocity, acceleration};
+    for (int i = 0; i < 3; i++) {
+        for (int j = 0; j < 3; j++) xx[i][j] += x[i] * x[j];
+        xy[i] += x[i] * power;
+    }
+    count++;
+}
+
+/**
+ * @brief Calculate the determinant of a 3x3 matrix
+ *
+ * @param m the matrix
+ * @return double
+ */
+static double determinant(const double m[3][3]) {
+    return m[0][0] * (m[1][1] * m[2][2] - m[1][2] * m[2][1]) - m[0][1] * (m[1][0] * m[2][2] - m[1][2] * m[2][0]) +
+           m[0][2] * (m[1][0] * m[2][1] - m[1][1] * m[2][0]);
+}
+
+/**
+ * @brief Fit the gains to the samples added so far
+ *
+ * @param gains the fitted gains. Unchanged if the fit fails
+ * @return true if there were enough varied samples to fit the gains
+ */
+bool lemlib::FeedforwardFit::solve(Feedforward_t& gains) {
+    if (count < 3) return false;
+    // solve the normal equations with Cramer's rule. The matrix is singular if the samples never varied in
+    // velocity or acceleration, so compare the determinant to the scale of the diagonal
+    double det = determinant(xx);
+    if (std::fabs(det) <= 1e-9 * xx[0][0] * xx[1][1] * xx[2][2]) return false;
+    double solution[3];
+    for (int k = 0; k < 3; k++) {
+        double m[3][3];
+        for (int i = 0; i < 3; i++) {
+            for (int j = 0; j < 3; j++) m[i][j] = (j == k) ? xy[i] : xx[i][j];
+        }
+        solution[k] = determinant(m) / det;
+    }
+    gains = {float(solution[0]), float(solution[1]), float(solution[2])};
+    return true;
+}
+
+/**
+ * @brief Get the number of samples added
+ *
+ * @return int
+ */
+int lemlib::FeedforwardFit::getCount() { return count; }
+
+/**
+ * @brief Remove all the samples
+ *
+ */
+void lemlib::FeedforwardFit::reset() { *this = FeedforwardFit(); }
+
+/**
+ * @brief Save a characterization result to a file
+ *
+ * The file is plain text, one side per line, so it can be checked or edited by hand
+ *
+ * @param filePath file path to save to. No need to preface it with /usd/
+ * @param result the result to save
+ * @return true if the file was written
+ */
+bool lemlib::saveCharacterization(const char* filePath, const CharacterizationResult_t& result) {
+    std::FILE* file = std::fopen(("/usd/" + std::string(filePath)).c_str(), "w");
+    if (file == nullptr) return false;
+    int written = std::fprintf(file, "left %f %f %f\nright %f %f %f\n", result.left.kS, result.left.kV,
+                               result.left.kA, result.right.kS, result.right.kV, result.right.kA);
+    std::fclose(file);
+    return written > 0;
+}
+
+/**
+ * @brief Load a characterization result from a file
+ *
+ * @param filePath file path to load from. No need to preface it with /usd/
+ * @param result the loaded result. Unchanged if the file couldn't be read
+ * @return true if the file was read
+ */
+bool lemlib::loadCharacterization(const char* filePath, CharacterizationResult_t& result) {
+    std::FILE* file = std::fopen(("/usd/" + std::string(filePath)).c_str(), "r");
+    if (file == nullptr) return false;
+    CharacterizationResult_t loaded;
+    int read = std::fscanf(file, " left %f %f %f right %f %f %f", &loaded.left.kS, &loaded.left.kV, &loaded.left.kA,
+                           &loaded.right.kS, &loaded.right.kV, &loaded.right.kA);
+    std::fclose(file);
+    if (read != 6) return false;
+    loaded.success = true;
+    result = loaded;
+    return true;
+}
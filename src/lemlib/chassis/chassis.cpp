@@ -13,6 +13,7 @@
 #include "pros/misc.hpp"
 #include "lemlib/util.hpp"
 #include "lemlib/pid.hpp"
+#include "lemlib/logger.hpp"
 #include "lemlib/chassis/chassis.hpp"
 #include "lemlib/chassis/odom.hpp"
 #include "trackingWheel.hpp"
@@ -38,13 +39,16 @@ lemlib::Chassis::Chassis(Drivetrain_t drivetrain, ChassisController_t lateralSet
  *
  */
 void lemlib::Chassis::calibrate() {
-    // calibrate the imu if it exists
-    if (odomSensors.imu != nullptr) {
-        odomSensors.imu->reset(true);
+    // calibrate the imus if they exist
+    pros::Imu* imus[4] = {odomSensors.imu, odomSensors.extraImus[0], odomSensors.extraImus[1],
+                          odomSensors.extraImus[2]};
+    for (pros::Imu* imu : imus) {
+        if (imu == nullptr) continue;
+        imu->reset(true);
         // keep on calibrating until it calibrates successfully
         while (errno == PROS_ERR || errno == ENODEV || errno == ENXIO) {
             pros::c::controller_rumble(pros::E_CONTROLLER_MASTER, "---");
-            odomSensors.imu->reset(true);
+            imu->reset(true);
             pros::delay(10);
         }
     }
@@ -93,6 +97,69 @@ void lemlib::Chassis::setPose(Pose pose, bool radians) { lemlib::setPose(pose, r
  */
 lemlib::Pose lemlib::Chassis::getPose(bool radians) { return lemlib::getPose(radians); }
 
+/**
+ * @brief Get the pose the chassis is expected to be at after some time
+ *
+ * @param dtMs how far ahead to predict, in milliseconds
+ * @param radians whether theta should be in radians (true) or degrees (false). false by default
+ * @return Pose
+ */
+lemlib::Pose lemlib::Chassis::getPredictedPose(float dtMs, bool radians) {
+    return lemlib::getPredictedPose(dtMs, radians);
+}
+
+/**
+ * @brief Set how far ahead motions predict the pose to compensate for latency
+ *
+ * @param latencyMs the latency to compensate for in milliseconds. 0 to disable, which is the default
+ */
+void lemlib::Chassis::setPrediction(float latencyMs) { predictionLatency = latencyMs; }
+
+/**
+ * @brief Get the pose used by the motion controllers
+ *
+ * @param radians whether theta should be in radians (true) or degrees (false). false by default
+ * @return Pose the predicted pose if prediction is enabled, otherwise the latest pose
+ */
+lemlib::Pose lemlib::Chassis::getControlPose(bool radians) {
+    if (predictionLatency > 0) return lemlib::getPredictedPose(predictionLatency, radians);
+    return lemlib::getPose(radians);
+}
+
+/**
+ * @brief Get the velocity of the chassis
+ *
+ * @param local true for the robot frame (x to the right, y forwards), false for the field frame. False by default
+ * @param radians true for angular velocity in radians per second, false for degrees per second. False by default
+ * @return Pose velocity in inches per second
+ */
+lemlib::Pose lemlib::Chassis::getVelocity(bool local, bool radians) { return lemlib::getVelocity(local, radians); }
+
+/**
+ * @brief Get the acceleration of the chassis
+ *
+ * @param local true for the robot frame (x to the right, y forwards), false for the field frame. False by default
+ * @param radians true for angular acceleration in radians per second squared, false for degrees. False by default
+ * @return Pose acceleration in inches per second squared
+ */
+lemlib::Pose lemlib::Chassis::getAcceleration(bool local, bool radians) {
+    return lemlib::getAcceleration(local, radians);
+}
+
+/**
+ * @brief Set the filter used by odometry to estimate velocity and acceleration
+ *
+ * @param settings the filter settings
+ */
+void lemlib::Chassis::setVelocityFilter(FilterSettings_t settings) { lemlib::setVelocityFilter(settings); }
+
+/**
+ * @brief Get the most recent sensor snapshot taken by odometry
+ *
+ * @return SensorSnapshot_t
+ */
+lemlib::SensorSnapshot_t lemlib::Chassis::getSensorSnapshot() { return lemlib::getSensorSnapshot(); }
+
 /**
  * @brief Turn the chassis so it is facing the target point
  *
@@ -116,11 +183,13 @@ void lemlib::Chassis::turnTo(float x, float y, int timeout, bool reversed, float
     FAPID pid = FAPID(0, 0, angularSettings.kP, 0, angularSettings.kD, "angularPID");
     pid.setExit(angularSettings.largeError, angularSettings.smallError, angularSettings.largeErrorTimeout,
                 angularSettings.smallErrorTimeout, timeout);
+    pid.setSchedule(angularSettings.schedule);
+    pid.setVelocityExit(angularSettings.settleError, angularSettings.settleSpeed);
 
     // main loop
     while (pros::competition::get_status() == compState && !pid.settled()) {
         // update variables
-        pose = getPose();
+        pose = getControlPose();
         pose.theta = (reversed) ? fmod(pose.theta - 180, 360) : fmod(pose.theta, 360);
         deltaX = x - pose.x;
         deltaY = y - pose.y;
@@ -173,11 +242,14 @@ void lemlib::Chassis::moveTo(float x, float y, int timeout, float maxSpeed, bool
     FAPID angularPID(0, 0, angularSettings.kP, 0, angularSettings.kD, "angularPID");
     lateralPID.setExit(lateralSettings.largeError, lateralSettings.smallError, lateralSettings.largeErrorTimeout,
                        lateralSettings.smallErrorTimeout, timeout);
+    lateralPID.setSchedule(lateralSettings.schedule);
+    lateralPID.setVelocityExit(lateralSettings.settleError, lateralSettings.settleSpeed);
+    angularPID.setSchedule(angularSettings.schedule);
 
     // main loop
     while (pros::competition::get_status() == compState && (!lateralPID.settled() || pros::millis() - start < 300)) {
         // get the current position
-        Pose pose = getPose();
+        Pose pose = getControlPose();
         pose.theta = std::fmod(pose.theta, 360);
 
         // update error
@@ -234,3 +306,369 @@ void lemlib::Chassis::moveTo(float x, float y, int timeout, float maxSpeed, bool
     drivetrain.leftMotors->move(0);
     drivetrain.rightMotors->move(0);
 }
+
+/**
+ * @brief Set the feedforward gains used by profiled motions
+ *
+ * @param lateral feedforward for driving, with velocity in inches per second
+ * @param angular feedforward for turning, with velocity in degrees per second
+ */
+void lemlib::Chassis::setFeedforward(Feedforward_t lateral, Feedforward_t angular) {
+    lateralFeedforward = lateral;
+    angularFeedforward = angular;
+}
+
+/**
+ * @brief Set the feedforward gains used by profiled motions from a characterization of the drivetrain
+ *
+ * @param result the characterization of the drivetrain
+ */
+void lemlib::Chassis::setFeedforward(CharacterizationResult_t result) {
+    Feedforward_t lateral = {(result.left.kS + result.right.kS) / 2, (result.left.kV + result.right.kV) / 2,
+                             (result.left.kA + result.right.kA) / 2};
+    // each side moves trackWidth / 2 inches for every radian the robot turns
+    float sideDistance = degToRad(1) * drivetrain.trackWidth / 2;
+    Feedforward_t angular = {lateral.kS, lateral.kV * sideDistance, lateral.kA * sideDistance};
+    setFeedforward(lateral, angular);
+}
+
+/**
+ * @brief Set the feedforward gains used by profiled motions from a saved characterization
+ *
+ * @param filePath file path to the characterization. No need to preface it with /usd/
+ * @return true if the characterization was loaded
+ */
+bool lemlib::Chassis::loadFeedforward(const char* filePath) {
+    CharacterizationResult_t result;
+    if (!loadCharacterization(filePath, result)) return false;
+    setFeedforward(result);
+    return true;
+}
+
+/**
+ * @brief Measure the feedforward gains of each side of the drivetrain
+ *
+ * @param settings the characterization settings
+ * @param filePath file path to save the result to. No need to preface it with /usd/. nullptr to not save it
+ * @param log whether to log every sample
+ * @return CharacterizationResult_t the fitted gains of each side
+ */
+lemlib::CharacterizationResult_t lemlib::Chassis::characterize(CharacterizeSettings_t settings, const char* filePath,
+                                                               bool log) {
+    MotorGroupEncoder leftEncoder(drivetrain.leftMotors, drivetrain.rpm);
+    MotorGroupEncoder rightEncoder(drivetrain.rightMotors, drivetrain.rpm);
+    float circumference = M_PI * drivetrain.wheelDiameter;
+    FeedforwardFit leftFit, rightFit;
+    std::uint8_t compState = pros::competition::get_status();
+
+    // run a single test. The direction is 1 for forwards, -1 for backwards
+    auto runTest = [&](bool step, float direction) {
+        // measure from where the test starts. Taring the motors would move odometry and slip detection
+        float leftStart = leftEncoder.getPosition();
+        float rightStart = rightEncoder.getPosition();
+        int start = pros::millis();
+        int prevTime = start;
+        float prevLeft = 0, prevRight = 0;
+        float leftAccel = 0, rightAccel = 0;
+        // the power sent to the motors on the last tick, which is what moved them over the interval measured now
+        float appliedPower = 0;
+        bool driven = false;
+        while (pros::competition::get_status() == compState && int(pros::millis()) - start < settings.timeout) {
+            float t = (pros::millis() - start) / 1000.0;
+            float power = step ? settings.stepPower : std::fmin(settings.rampRate * t, 127);
+            power *= direction;
+
+            // measure the velocity of each side, and differentiate it for the acceleration
+            float leftVelocity = leftEncoder.getVelocity() * circumference;
+            float rightVelocity = rightEncoder.getVelocity() * circumference;
+            int now = pros::millis();
+            if (now > prevTime) {
+                float dt = (now - prevTime) / 1000.0;
+                // the differences are noisy, so smooth them
+                leftAccel += 0.3 * ((leftVelocity - prevLeft) / dt - leftAccel);
+                rightAccel += 0.3 * ((rightVelocity - prevRight) / dt - rightAccel);
+            }
+            prevTime = now;
+            prevLeft = leftVelocity;
+            prevRight = rightVelocity;
+
+            // only fit samples where the robot is moving in the direction it is driven, with the power that produced
+            // the velocity and acceleration rather than the power about to be sent
+            if (driven && leftVelocity * direction > settings.minVelocity)
+                leftFit.addSample(appliedPower, leftVelocity, leftAccel);
+            if (driven && rightVelocity * direction > settings.minVelocity)
+                rightFit.addSample(appliedPower, rightVelocity, rightAccel);
+            if (log) {
+                // the tracking wheel velocities sampled by odometry this tick
+                SensorSnapshot_t snapshot = getSensorSnapshot();
+                LEMLIB_INFO("characterize %lu, %.1f, %.2f, %.2f, %.2f, %.2f", (unsigned long)pros::millis(), power,
+                            leftVelocity, rightVelocity, snapshot.vertical1Velocity, snapshot.vertical2Velocity);
+            }
+
+            // stop before the robot runs out of room
+            float leftDistance = leftEncoder.getPosition() - leftStart;
+            float rightDistance = rightEncoder.getPosition() - rightStart;
+            float distance = (leftDistance + rightDistance) / 2 * circumference;
+            if (std::fabs(distance) > settings.maxDistance) break;
+            drivetrain.leftMotors->move(power);
+            drivetrain.rightMotors->move(power);
+            appliedPower = power;
+            driven = true;
+            pros::delay(10);
+        }
+        // let the robot come to a stop before the next test
+        drivetrain.leftMotors->move(0);
+        drivetrain.rightMotors->move(0);
+        pros::delay(1000);
+    };
+
+    // each pair of tests drives forwards then back, so the robot ends up roughly where it started
+    runTest(false, 1);
+    runTest(false, -1);
+    runTest(true, 1);
+    runTest(true, -1);
+
+    CharacterizationResult_t result = {false, {0, 0, 0}, {0, 0, 0}};
+    result.success = leftFit.solve(result.left) && rightFit.solve(result.right);
+    if (result.success) {
+        setFeedforward(result);
+        if (filePath != nullptr) saveCharacterization(filePath, result);
+    }
+    return result;
+}
+
+/**
+ * @brief Calculate the feedforward for a point of a profile
+ *
+ * @param gains the feedforward gains
+ * @param state the point of the profile
+ * @return float motor power
+ */
+static float feedforward(lemlib::Feedforward_t gains, lemlib::ProfileState_t state) {
+    float friction = (state.velocity == 0) ? 0 : gains.kS * lemlib::sgn(state.velocity);
+    return friction + gains.kV * state.velocity + gains.kA * state.acceleration;
+}
+
+/**
+ * @brief Lower the velocity limit of a profile to what the feedforward can hold within a max speed
+ *
+ * @param gains the feedforward gains
+ * @param constraints the velocity and acceleration limits
+ * @param maxSpeed the largest motor power
+ * @return lemlib::ProfileConstraints_t the limits, with a velocity that needs at most maxSpeed to hold
+ */
+static lemlib::ProfileConstraints_t limitVelocity(lemlib::Feedforward_t gains, lemlib::ProfileConstraints_t constraints,
+                                                  float maxSpeed) {
+    // without a velocity gain there is no relation between the velocity and the power to go by
+    if (gains.kV > 0) {
+        float maxVelocity = std::fmax(maxSpeed - gains.kS, 0) / gains.kV;
+        constraints.maxVelocity = std::fmin(constraints.maxVelocity, maxVelocity);
+    }
+    return constraints;
+}
+
+/**
+ * @brief Turn the chassis so it is facing the target point, following a motion profile
+ *
+ * The PID logging id is "angularPID"
+ *
+ * @param x x location
+ * @param y y location
+ * @param timeout longest time the robot can spend moving
+ * @param constraints the velocity and acceleration limits, in degrees per second and degrees per second squared
+ * @param shape the shape of the profile. S_CURVE by default
+ * @param reversed whether the robot should turn in the opposite direction. false by default
+ * @param maxSpeed the maximum speed the robot can turn at. Default is 127
+ * @param log whether the chassis should log the turnTo function. false by default
+ */
+void lemlib::Chassis::turnToProfiled(float x, float y, int timeout, ProfileConstraints_t constraints,
+                                     ProfileShape shape, bool reversed, float maxSpeed, bool log) {
+    float prevMotorPower = 0;
+    int start = pros::millis();
+    std::uint8_t compState = pros::competition::get_status();
+
+    // plan the turn from the current heading
+    Pose pose = getControlPose();
+    float startTheta = (reversed) ? pose.theta - 180 : pose.theta;
+    float targetTheta = radToDeg(M_PI_2 - atan2(y - pose.y, x - pose.x));
+    MotionProfile profile(angleError(targetTheta, startTheta), limitVelocity(angularFeedforward, constraints, maxSpeed),
+                          shape);
+
+    // create a new PID controller
+    FAPID pid = FAPID(0, 0, angularSettings.kP, 0, angularSettings.kD, "angularPID");
+    pid.setExit(angularSettings.largeError, angularSettings.smallError, angularSettings.largeErrorTimeout,
+                angularSettings.smallErrorTimeout, -1);
+    pid.setSchedule(angularSettings.schedule);
+    pid.setVelocityExit(angularSettings.settleError, angularSettings.settleSpeed);
+
+    // main loop
+    while (pros::competition::get_status() == compState && int(pros::millis()) - start < timeout) {
+        float t = (pros::millis() - start) / 1000.0;
+        ProfileState_t state = profile.sample(t);
+
+        // difference between the profile and the measured heading
+        pose = getControlPose();
+        float theta = (reversed) ? pose.theta - 180 : pose.theta;
+        float deltaTheta = angleError(startTheta + state.position, theta);
+
+        // the turnTo controller turns counterclockwise for positive power
+        float motorPower = -feedforward(angularFeedforward, state) - pid.update(deltaTheta, 0, log);
+        bool settled = pid.settled();
+        if (t >= profile.getDuration() && settled) break;
+
+        // limit acceleration
+        if (std::fabs(deltaTheta) > 25) motorPower = lemlib::slew(motorPower, prevMotorPower, angularSettings.slew);
+
+        // cap the speed
+        if (motorPower > maxSpeed) motorPower = maxSpeed;
+        else if (motorPower < -maxSpeed) motorPower = -maxSpeed;
+        prevMotorPower = motorPower;
+
+        // move the drivetrain
+        drivetrain.leftMotors->move(-motorPower);
+        drivetrain.rightMotors->move(motorPower);
+
+        pros::delay(10);
+    }
+
+    // stop the drivetrain
+    drivetrain.leftMotors->move(0);
+    drivetrain.rightMotors->move(0);
+}
+
+/**
+ * @brief Move the chassis to the target point, following a motion profile
+ *
+ * The PID logging ids are "angularPID" and "lateralPID"
+ *
+ * @param x x location
+ * @param y y location
+ * @param timeout longest time the robot can spend moving
+ * @param constraints the velocity and acceleration limits, in inches per second and inches per second squared
+ * @param shape the shape of the profile. S_CURVE by default
+ * @param maxSpeed the maximum speed the robot can move at. Default is 127
+ * @param log whether the chassis should log the moveTo function. false by default
+ */
+void lemlib::Chassis::moveToProfiled(float x, float y, int timeout, ProfileConstraints_t constraints,
+                                     ProfileShape shape, float maxSpeed, bool log) {
+    float prevLateralPower = 0;
+    float prevAngularPower = 0;
+    int start = pros::millis();
+    std::uint8_t compState = pros::competition::get_status();
+
+    // plan the motion along the line from the current position to the target
+    Pose startPose = getControlPose();
+    float distance = startPose.distance(Pose(x, y));
+    float directionX = (distance > 0) ? (x - startPose.x) / distance : 0;
+    float directionY = (distance > 0) ? (y - startPose.y) / distance : 0;
+    float targetTheta = radToDeg(M_PI_2 - atan2(y - startPose.y, x - startPose.x));
+    // drive backwards if the robot is facing away from the target
+    bool backwards = std::fabs(angleError(startPose.theta, targetTheta)) > 90;
+    MotionProfile profile(backwards ? -distance : distance, limitVelocity(lateralFeedforward, constraints, maxSpeed),
+                          shape);
+
+    // create new PID controllers
+    FAPID lateralPID(0, 0, lateralSettings.kP, 0, lateralSettings.kD, "lateralPID");
+    FAPID angularPID(0, 0, angularSettings.kP, 0, angularSettings.kD, "angularPID");
+    lateralPID.setExit(lateralSettings.largeError, lateralSettings.smallError, lateralSettings.largeErrorTimeout,
+                       lateralSettings.smallErrorTimeout, -1);
+    lateralPID.setSchedule(lateralSettings.schedule);
+    lateralPID.setVelocityExit(lateralSettings.settleError, lateralSettings.settleSpeed);
+    angularPID.setSchedule(angularSettings.schedule);
+
+    // main loop
+    while (pros::competition::get_status() == compState && int(pros::millis()) - start < timeout) {
+        float t = (pros::millis() - start) / 1000.0;
+        ProfileState_t state = profile.sample(t);
+
+        // progress along the line, signed in the direction of travel
+        Pose pose = getControlPose();
+        float progress = (pose.x - startPose.x) * directionX + (pose.y - startPose.y) * directionY;
+        if (backwards) progress = -progress;
+        float lateralError = state.position - progress;
+        float lateralPower = feedforward(lateralFeedforward, state) + lateralPID.update(lateralError, 0, log);
+
+        // keep pointing at the target, until the robot is too close for the heading to be meaningful
+        float angularPower = 0;
+        float angularError = 0;
+        bool close = pose.distance(Pose(x, y)) <= 7.5;
+        if (!close) {
+            float heading = radToDeg(M_PI_2 - atan2(y - pose.y, x - pose.x));
+            angularError = angleError(pose.theta, backwards ? heading + 180 : heading);
+            angularPower = -angularPID.update(angularError, 0, log);
+        }
+
+        bool settled = lateralPID.settled();
+        if (t >= profile.getDuration() && settled) break;
+
+        // limit acceleration
+        if (!close) lateralPower = lemlib::slew(lateralPower, prevLateralPower, lateralSettings.slew);
+        if (std::fabs(angularError) > 25)
+            angularPower = lemlib::slew(angularPower, prevAngularPower, angularSettings.slew);
+
+        // cap the speed
+        if (lateralPower > maxSpeed) lateralPower = maxSpeed;
+        else if (lateralPower < -maxSpeed) lateralPower = -maxSpeed;
+
+        prevLateralPower = lateralPower;
+        prevAngularPower = angularPower;
+
+        // ratio the speeds to respect the max speed
+        float leftPower = lateralPower + angularPower;
+        float rightPower = lateralPower - angularPower;
+        float ratio = std::max(std::fabs(leftPower), std::fabs(rightPower)) / maxSpeed;
+        if (ratio > 1) {
+            leftPower /= ratio;
+            rightPower /= ratio;
+        }
+
+        // move the motors
+        drivetrain.leftMotors->move(leftPower);
+        drivetrain.rightMotors->move(rightPower);
+
+        pros::delay(10);
+    }
+
+    // stop the drivetrain
+    drivetrain.leftMotors->move(0);
+    drivetrain.rightMotors->move(0);
+}
+
+/**
+ * @brief Find gains for a chassis controller by oscillating the drivetrain around its current pose
+ *
+ * @param angular true to tune the angular controller, false to tune the lateral controller
+ * @param settings the autotuning settings. The hysteresis is in degrees for angular, inches for lateral
+ * @return AutotuneResult_t the measured oscillation and proposed gains
+ */
+lemlib::AutotuneResult_t lemlib::Chassis::autotune(bool angular, AutotuneSettings_t settings) {
+    RelayAutotuner tuner(settings);
+    Pose target = getPose();
+    int start = pros::millis();
+    std::uint8_t compState = pros::competition::get_status();
+
+    while (pros::competition::get_status() == compState && !tuner.isDone()) {
+        if (int(pros::millis()) - start > settings.timeout) break;
+        Pose pose = getPose();
+        if (angular) {
+            // same sign as the error of the turnTo controller
+            float error = -angleError(target.theta, pose.theta);
+            float power = tuner.update(error, pros::millis());
+            drivetrain.leftMotors->move(-power);
+            drivetrain.rightMotors->move(power);
+        } else {
+            // distance to the starting point along the heading of the robot
+            float theta = degToRad(pose.theta);
+            float error = (target.x - pose.x) * sin(theta) + (target.y - pose.y) * cos(theta);
+            float power = tuner.update(error, pros::millis());
+            drivetrain.leftMotors->move(power);
+            drivetrain.rightMotors->move(power);
+        }
+        pros::delay(10);
+    }
+
+    // stop the drivetrain
+    drivetrain.leftMotors->move(0);
+    drivetrain.rightMotors->move(0);
+    return tuner.getResult();
+}
@@ -0,0 +1,83 @@
+/**
+ * @file src/lemlib/chassis/encoder.cpp
+ * @author LemLib Team
+ * @brief Encoder backends used by tracking wheels
+ * @version 0.4.5
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#include <algorithm>
+#include "lemlib/util.hpp"
+#include "lemlib/chassis/encoder.hpp"
+
+/**
+ * @brief Create a new motor group encoder
+ *
+ * @param motors the motor group to use
+ * @param rpm theoretical maximum rpm of the drivetrain wheels
+ */
+lemlib::MotorGroupEncoder::MotorGroupEncoder(pros::Motor_Group* motors, float rpm)
+    : motors(motors),
+      rpm(rpm) {
+    this->motors->set_encoder_units(pros::E_MOTOR_ENCODER_ROTATIONS);
+    this->cacheMotors();
+}
+
+/**
+ * @brief Cache the port and gear ratio of every motor in the motor group
+ *
+ */
+void lemlib::MotorGroupEncoder::cacheMotors() {
+    std::vector<std::uint8_t> ports = this->motors->get_ports();
+    this->motorCount = std::min<int>(ports.size(), MAX_MOTORS);
+    for (int i = 0; i < this->motorCount; i++) {
+        float in;
+        switch (pros::c::motor_get_gearing(ports[i])) {
+            case pros::E_MOTOR_GEARSET_36: in = 100; break;
+            case pros::E_MOTOR_GEARSET_18: in = 200; break;
+            case pros::E_MOTOR_GEARSET_06: in = 600; break;
+            default: in = 200; break;
+        }
+        this->ports[i] = ports[i];
+        this->ratios[i] = rpm / in;
+    }
+}
+
+/**
+ * @brief Get the average number of rotations of the drivetrain wheels
+ *
+ * @return float rotations
+ */
+float lemlib::MotorGroupEncoder::getPosition() {
+    float rotations[MAX_MOTORS];
+    for (int i = 0; i < this->motorCount; i++) {
+        rotations[i] = pros::c::motor_get_position(this->ports[i]) * this->ratios[i];
+    }
+    return lemlib::avg(rotations, this->motorCount);
+}
+
+/**
+ * @brief Get the average velocity of the drivetrain wheels, as measured by the motors
+ *
+ * @return float rotations per second
+ */
+float lemlib::MotorGroupEncoder::getVelocity() {
+    float velocities[MAX_MOTORS];
+    for (int i = 0; i < this->motorCount; i++) {
+        // rpm to rotations per second
+        velocities[i] = pros::c::motor_get_actual_velocity(this->ports[i]) * this->ratios[i] / 60;
+    }
+    return lemlib::avg(velocities, this->motorCount);
+}
+
+/**
+ * @brief Reset the position to 0, and read the gearing of the motors again
+ *
+ */
+void lemlib::MotorGroupEncoder::reset() {
+    this->motors->tare_position();
+    this->cacheMotors();
+}
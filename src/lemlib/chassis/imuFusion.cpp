@@ -0,0 +1,151 @@
+/**
+ * @file src/lemlib/chassis/imuFusion.cpp
+ * @author LemLib Team
+ * @brief Multi-IMU heading fusion definitions
+ * @version 0.4.5
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#include <cmath>
+#include "lemlib/chassis/imuFusion.hpp"
+
+/**
+ * @brief Construct a new Imu Fusion
+ *
+ * @param settings the fusion settings
+ */
+lemlib::ImuFusion::ImuFusion(FusionSettings_t settings) { this->settings = settings; }
+
+/**
+ * @brief Add the readings of a tick
+ *
+ * @param rotations the rotation of each IMU in radians. Readings that aren't finite are ignored
+ * @param count the number of IMUs
+ * @param dt time since the last tick in seconds
+ * @param stationary whether the robot is known to be stationary
+ * @return float the fused rotation in radians
+ */
+float lemlib::ImuFusion::update(const float* rotations, int count, float dt, bool stationary) {
+    if (count > MAX_IMUS) count = MAX_IMUS;
+    if (!initialized) {
+        for (int i = 0; i < count; i++) prevRotations[i] = rotations[i];
+        initialized = true;
+        return rotation;
+    }
+
+    // calculate the corrected change in rotation of each IMU
+    float raw[MAX_IMUS];
+    float corrected[MAX_IMUS];
+    bool finite[MAX_IMUS];
+    float sorted[MAX_IMUS];
+    int finiteCount = 0;
+    for (int i = 0; i < count; i++) {
+        // a disconnected IMU reads PROS_ERR_F
+        finite[i] = std::isfinite(rotations[i]) && std::isfinite(prevRotations[i]);
+        if (finite[i]) raw[i] = rotations[i] - prevRotations[i];
+        prevRotations[i] = rotations[i];
+        if (!finite[i]) continue;
+        corrected[i] = (raw[i] - bias[i] * dt) * scale[i];
+        // insert it in order. There are at most MAX_IMUS, so this is cheaper than sorting them afterwards
+        int j = finiteCount++;
+        for (; j > 0 && sorted[j - 1] > corrected[i]; j--) sorted[j] = sorted[j - 1];
+        sorted[j] = corrected[i];
+    }
+    if (finiteCount == 0) {
+        validCount = 0;
+        return rotation;
+    }
+
+    // find the reference change in rotation
+    float reference = sorted[finiteCount / 2];
+    if (finiteCount % 2 == 0) reference = (sorted[finiteCount / 2 - 1] + reference) / 2;
+    // with only 2 IMUs there is no majority, so trust the one closest to the last tick
+    if (finiteCount == 2 && sorted[1] - sorted[0] > settings.outlierThreshold)
+        reference = (std::fabs(sorted[0] - lastDelta) < std::fabs(sorted[1] - lastDelta)) ? sorted[0] : sorted[1];
+
+    // average the IMUs that agree with the reference
+    float sum = 0;
+    validCount = 0;
+    for (int i = 0; i < count; i++) {
+        if (!finite[i] || std::fabs(corrected[i] - reference) > settings.outlierThreshold) continue;
+        sum += corrected[i];
+        validCount++;
+    }
+    float delta = (validCount > 0) ? sum / validCount : reference;
+
+    // learn the bias while stationary, and the scale while turning
+    if (stationary && dt > 0 && std::fabs(delta) / dt < 0.05) {
+        for (int i = 0; i < count; i++) {
+            if (finite[i]) bias[i] += settings.biasRate * (raw[i] / dt - bias[i]);
+        }
+    } else if (std::fabs(delta) > settings.minScaleRotation) {
+        float scaleSum = 0;
+        int scaleCount = 0;
+        for (int i = 0; i < count; i++) {
+            if (!finite[i]) continue;
+            float unscaled = raw[i] - bias[i] * dt;
+            if (std::fabs(corrected[i] - reference) <= settings.outlierThreshold && unscaled != 0)
+                scale[i] += settings.scaleRate * (delta / unscaled - scale[i]);
+            scaleSum += scale[i];
+            scaleCount++;
+        }
+        // the scales are relative to each other, so keep their average at 1
+        for (int i = 0; i < count; i++) {
+            if (finite[i]) scale[i] *= scaleCount / scaleSum;
+        }
+    }
+
+    rotation += delta;
+    lastDelta = delta;
+    return rotation;
+}
+
+/**
+ * @brief Reset the fused rotation, keeping the learned bias and scale
+ *
+ * @param rotation the new fused rotation in radians
+ */
+void lemlib::ImuFusion::reset(float rotation) {
+    this->rotation = rotation;
+    initialized = false;
+    lastDelta = 0;
+}
+
+/**
+ * @brief Change the fusion settings, keeping the fused rotation and the learned bias and scale
+ *
+ * @param settings the new fusion settings
+ */
+void lemlib::ImuFusion::setSettings(FusionSettings_t settings) { this->settings = settings; }
+
+/**
+ * @brief Get the estimated bias of an IMU
+ *
+ * @param index the index of the IMU
+ * @return float bias in radians per second
+ */
+float lemlib::ImuFusion::getBias(int index) {
+    if (index < 0 || index >= MAX_IMUS) return 0;
+    return bias[index];
+}
+
+/**
+ * @brief Get the estimated scale of an IMU relative to the others
+ *
+ * @param index the index of the IMU
+ * @return float scale
+ */
+float lemlib::ImuFusion::getScale(int index) {
+    if (index < 0 || index >= MAX_IMUS) return 1;
+    return scale[index];
+}
+
+/**
+ * @brief Get the number of IMUs used in the last tick
+ *
+ * @return int
+ */
+int lemlib::ImuFusion::getValidCount() { return validCount; }
@@ -0,0 +1,86 @@
+/**
+ * @file src/lemlib/chassis/latency.cpp
+ * @author LemLib Team
+ * @brief Sensor read latency histogram definitions
+ * @version 0.4.5
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#include "lemlib/chassis/latency.hpp"
+
+/**
+ * @brief Record a duration
+ *
+ * @param micros the duration in microseconds
+ */
+void lemlib::LatencyHistogram::record(std::uint32_t micros) {
+    // the bucket is the number of bits needed to store the duration
+    int bucket = (micros == 0) ? 0 : 32 - __builtin_clz(micros);
+    if (bucket >= BUCKETS) bucket = BUCKETS - 1;
+    buckets[bucket]++;
+    count++;
+    total += micros;
+    if (micros > max) max = micros;
+}
+
+/**
+ * @brief Clear every recorded duration
+ *
+ */
+void lemlib::LatencyHistogram::reset() { *this = LatencyHistogram(); }
+
+/**
+ * @brief Get the number of recorded durations
+ *
+ * @return std::uint32_t
+ */
+std::uint32_t lemlib::LatencyHistogram::getCount() const { return count; }
+
+/**
+ * @brief Get the number of recorded durations in a bucket
+ *
+ * @param bucket the bucket, from 0 to BUCKETS - 1
+ * @return std::uint32_t
+ */
+std::uint32_t lemlib::LatencyHistogram::getBucket(int bucket) const {
+    if (bucket < 0 || bucket >= BUCKETS) return 0;
+    return buckets[bucket];
+}
+
+/**
+ * @brief Get the mean duration
+ *
+ * @return float mean in microseconds, 0 if nothing was recorded
+ */
+float lemlib::LatencyHistogram::getMean() const {
+    if (count == 0) return 0;
+    return float(total) / count;
+}
+
+/**
+ * @brief Get the longest duration
+ *
+ * @return std::uint32_t longest duration in microseconds
+ */
+std::uint32_t lemlib::LatencyHistogram::getMax() const { return max; }
+
+/**
+ * @brief Get an upper bound on a percentile of the durations
+ *
+ * @param percentile the percentile, from 0 to 100
+ * @return std::uint32_t upper edge of the bucket the percentile falls in, in microseconds
+ */
+std::uint32_t lemlib::LatencyHistogram::getPercentile(float percentile) const {
+    if (count == 0) return 0;
+    float target = count * percentile / 100;
+    std::uint32_t seen = 0;
+    for (int i = 0; i < BUCKETS; i++) {
+        seen += buckets[i];
+        // the upper edge of the bucket, unless the longest duration is shorter
+        if (seen >= target && seen > 0) return (i == BUCKETS - 1 || max < (1u << i)) ? max : (1u << i);
+    }
+    return max;
+}
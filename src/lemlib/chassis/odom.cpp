@@ -15,9 +15,15 @@
 // http://thepilons.ca/wp-content/uploads/2018/10/Tracking.pdf
 
 #include <math.h>
+#include <algorithm>
+#include <atomic>
 #include "pros/rtos.hpp"
 #include "lemlib/util.hpp"
+#include "lemlib/logger.hpp"
+#include "lemlib/filter.hpp"
 #include "lemlib/chassis/odom.hpp"
+#include "lemlib/chassis/recorder.hpp"
+#include "lemlib/chassis/relocalize.hpp"
 #include "lemlib/chassis/chassis.hpp"
 #include "lemlib/chassis/trackingWheel.hpp"
 
@@ -25,82 +31,113 @@
 pros::Task* trackingTask = nullptr;
 
 // global variables
-lemlib::OdomSensors_t odomSensors; // the sensors to be used for odometry
-lemlib::Drivetrain_t drive; // the drivetrain to be used for odometry
-lemlib::Pose odomPose(0, 0, 0); // the pose of the robot
+lemlib::Odometry* const odometry = new lemlib::Odometry(); // the primary estimator. Reconfigured, never replaced
+lemlib::Odometry* estimators[4]; // estimators running alongside the primary one
+std::atomic<int> estimatorCount(0);
+pros::Mutex trackingMutex; // held while the estimators are sampled, updated or reconfigured
 
-float prevVertical = 0;
-float prevVertical1 = 0;
-float prevVertical2 = 0;
-float prevHorizontal = 0;
-float prevHorizontal1 = 0;
-float prevHorizontal2 = 0;
-float prevImu = 0;
+/**
+ * @brief Construct an estimator without any sensors. Its pose never changes
+ *
+ */
+lemlib::Odometry::Odometry() {
+    this->sensors = {nullptr, nullptr, nullptr, nullptr, nullptr, {nullptr, nullptr, nullptr}};
+    this->drivetrain = {nullptr, nullptr, 0, 0, 0};
+    resolve(HeadingSource::IMU, true);
+}
 
 /**
- * @brief Set the sensors to be used for odometry
+ * @brief Construct a new Odometry estimator
  *
  * @param sensors the sensors to be used
  * @param drivetrain drivetrain to be used
  */
-void lemlib::setSensors(lemlib::OdomSensors_t sensors, lemlib::Drivetrain_t drivetrain) {
-    odomSensors = sensors;
-    drive = drivetrain;
+lemlib::Odometry::Odometry(OdomSensors_t sensors, Drivetrain_t drivetrain) {
+    this->sensors = sensors;
+    this->drivetrain = drivetrain;
+    resolve(HeadingSource::IMU, true);
 }
 
 /**
- * @brief Get the pose of the robot
+ * @brief Construct a new Odometry estimator with a specific heading source
  *
- * @param radians true for theta in radians, false for degrees. False by default
- * @return Pose
+ * @param sensors the sensors to be used
+ * @param drivetrain drivetrain to be used
+ * @param headingSource the sensors used to calculate the heading
  */
-lemlib::Pose lemlib::getPose(bool radians) {
-    if (radians) return odomPose;
-    else return lemlib::Pose(odomPose.x, odomPose.y, radToDeg(odomPose.theta));
+lemlib::Odometry::Odometry(OdomSensors_t sensors, Drivetrain_t drivetrain, HeadingSource headingSource) {
+    this->sensors = sensors;
+    this->drivetrain = drivetrain;
+    resolve(headingSource, false);
 }
 
 /**
- * @brief Set the Pose of the robot
+ * @brief Destroy the Odometry estimator, and the drivetrain tracking wheels it created for slip detection
  *
- * @param pose the new pose
- * @param radians true if theta is in radians, false if in degrees. False by default
  */
-void lemlib::setPose(lemlib::Pose pose, bool radians) {
-    if (radians) odomPose = pose;
-    else odomPose = lemlib::Pose(pose.x, pose.y, degToRad(pose.theta));
+lemlib::Odometry::~Odometry() {
+    delete leftDriveWheel;
+    delete rightDriveWheel;
 }
 
 /**
- * @brief Update the pose of the robot
+ * @brief Reconfigure the estimator for new sensors, keeping its pose
  *
+ * @param sensors the sensors to be used
+ * @param drivetrain drivetrain to be used
  */
-void lemlib::update() {
-    // TODO: add particle filter
-    // get the current sensor values
-    float vertical1Raw = 0;
-    float vertical2Raw = 0;
-    float horizontal1Raw = 0;
-    float horizontal2Raw = 0;
-    float imuRaw = 0;
-    if (odomSensors.vertical1 != nullptr) vertical1Raw = odomSensors.vertical1->getDistanceTraveled();
-    if (odomSensors.vertical2 != nullptr) vertical2Raw = odomSensors.vertical2->getDistanceTraveled();
-    if (odomSensors.horizontal1 != nullptr) horizontal1Raw = odomSensors.horizontal1->getDistanceTraveled();
-    if (odomSensors.horizontal2 != nullptr) horizontal2Raw = odomSensors.horizontal2->getDistanceTraveled();
-    if (odomSensors.imu != nullptr) imuRaw = degToRad(odomSensors.imu->get_rotation());
-
-    // calculate the change in sensor values
-    float deltaVertical1 = vertical1Raw - prevVertical1;
-    float deltaVertical2 = vertical2Raw - prevVertical2;
-    float deltaHorizontal1 = horizontal1Raw - prevHorizontal1;
-    float deltaHorizontal2 = horizontal2Raw - prevHorizontal2;
-    float deltaImu = imuRaw - prevImu;
-
-    // update the previous sensor values
-    prevVertical1 = vertical1Raw;
-    prevVertical2 = vertical2Raw;
-    prevHorizontal1 = horizontal1Raw;
-    prevHorizontal2 = horizontal2Raw;
-    prevImu = imuRaw;
+void lemlib::Odometry::setSensors(OdomSensors_t sensors, Drivetrain_t drivetrain) {
+    this->sensors = sensors;
+    this->drivetrain = drivetrain;
+    // the drivetrain tracking wheels belong to the old drivetrain
+    delete leftDriveWheel;
+    delete rightDriveWheel;
+    leftDriveWheel = nullptr;
+    rightDriveWheel = nullptr;
+    resolve(HeadingSource::IMU, true);
+    // the new sensors read from different zeros
+    seeded = false;
+}
+
+/**
+ * @brief Resolve which sensors and formulas to use, so update() doesn't have to
+ *
+ * @param headingSource the requested heading source
+ * @param automatic true to ignore the requested heading source and choose one automatically
+ */
+void lemlib::Odometry::resolve(HeadingSource headingSource, bool automatic) {
+    // list the wheels that need to be sampled
+    wheelCount = 0;
+    TrackingWheel* slots[4] = {sensors.vertical1, sensors.vertical2, sensors.horizontal1, sensors.horizontal2};
+    float SensorSnapshot_t::*readings[4] = {&SensorSnapshot_t::vertical1, &SensorSnapshot_t::vertical2,
+                                            &SensorSnapshot_t::horizontal1, &SensorSnapshot_t::horizontal2};
+    float SensorSnapshot_t::*velocities[4] = {
+        &SensorSnapshot_t::vertical1Velocity, &SensorSnapshot_t::vertical2Velocity,
+        &SensorSnapshot_t::horizontal1Velocity, &SensorSnapshot_t::horizontal2Velocity};
+    for (int i = 0; i < 4; i++) {
+        if (slots[i] == nullptr) continue;
+        wheels[wheelCount] = slots[i];
+        wheelReadings[wheelCount] = readings[i];
+        wheelVelocities[wheelCount] = velocities[i];
+        wheelDevices[wheelCount] = SensorDevice(i);
+        wheelCount++;
+    }
+    sensorWheelCount = wheelCount;
+
+    // list the imus that need to be sampled. The extra imus are only used alongside the main one
+    imuCount = 0;
+    if (sensors.imu != nullptr) {
+        imus[imuCount++] = sensors.imu;
+        for (pros::Imu* imu : sensors.extraImus) {
+            if (imu != nullptr) imus[imuCount++] = imu;
+        }
+    }
+
+    // check which heading sources are available
+    bool horizontalPair = sensors.horizontal1 != nullptr && sensors.horizontal2 != nullptr;
+    bool verticalPair = sensors.vertical1 != nullptr && sensors.vertical2 != nullptr;
+    bool unpoweredPair = verticalPair && !sensors.vertical1->getType() && !sensors.vertical2->getType();
+    bool available[4] = {horizontalPair, unpoweredPair, sensors.imu != nullptr, verticalPair};
 
     // calculate the heading of the robot
     // Priority:
@@ -108,49 +145,288 @@ void lemlib::update() {
     // 2. Vertical tracking wheels
     // 3. Inertial Sensor
     // 4. Drivetrain
-    float heading = odomPose.theta;
-    // calculate the heading using the horizontal tracking wheels
-    if (odomSensors.horizontal1 != nullptr && odomSensors.horizontal2 != nullptr)
-        heading += (deltaHorizontal1 - deltaHorizontal2) /
-                   (odomSensors.horizontal1->getOffset() - odomSensors.horizontal2->getOffset());
-    // else, if both vertical tracking wheels aren't substituted by the drivetrain, use the vertical tracking wheels
-    else if (!odomSensors.vertical1->getType() && !odomSensors.vertical2->getType())
-        heading += (deltaVertical1 - deltaVertical2) /
-                   (odomSensors.vertical1->getOffset() - odomSensors.vertical2->getOffset());
-    // else, if the inertial sensor exists, use it
-    else if (odomSensors.imu != nullptr) heading += deltaImu;
-    // else, use the the substituted tracking wheels
-    else
-        heading += (deltaVertical1 - deltaVertical2) /
-                   (odomSensors.vertical1->getOffset() - odomSensors.vertical2->getOffset());
-    float deltaHeading = heading - odomPose.theta;
-    float avgHeading = odomPose.theta + deltaHeading / 2;
+    if (automatic || !available[static_cast<int>(headingSource)]) {
+        headingSource = HeadingSource::IMU; // used when no heading source is available at all
+        for (int i = 3; i >= 0; i--) {
+            if (available[i]) headingSource = static_cast<HeadingSource>(i);
+        }
+    }
+    this->headingSource = headingSource;
+    switch (headingSource) {
+        case HeadingSource::HORIZONTAL_WHEELS:
+            headingA = &SensorSnapshot_t::horizontal1;
+            headingB = &SensorSnapshot_t::horizontal2;
+            headingVelocityA = &SensorSnapshot_t::horizontal1Velocity;
+            headingVelocityB = &SensorSnapshot_t::horizontal2Velocity;
+            headingScale = 1 / (sensors.horizontal1->getOffset() - sensors.horizontal2->getOffset());
+            break;
+        case HeadingSource::VERTICAL_WHEELS:
+        case HeadingSource::DRIVETRAIN:
+            headingA = &SensorSnapshot_t::vertical1;
+            headingB = &SensorSnapshot_t::vertical2;
+            headingVelocityA = &SensorSnapshot_t::vertical1Velocity;
+            headingVelocityB = &SensorSnapshot_t::vertical2Velocity;
+            headingScale = 1 / (sensors.vertical1->getOffset() - sensors.vertical2->getOffset());
+            break;
+        case HeadingSource::IMU: headingScale = (sensors.imu != nullptr) ? 1 : 0; break;
+    }
 
     // choose tracking wheels to use
     // Prioritize non-powered tracking wheels
-    lemlib::TrackingWheel* verticalWheel = nullptr;
-    lemlib::TrackingWheel* horizontalWheel = nullptr;
-    if (!odomSensors.vertical1->getType()) verticalWheel = odomSensors.vertical1;
-    else if (!odomSensors.vertical2->getType()) verticalWheel = odomSensors.vertical2;
-    else verticalWheel = odomSensors.vertical1;
-    if (odomSensors.horizontal1 != nullptr) horizontalWheel = odomSensors.horizontal1;
-    else if (odomSensors.horizontal2 != nullptr) horizontalWheel = odomSensors.horizontal2;
-    float rawVertical = 0;
-    float rawHorizontal = 0;
-    if (verticalWheel != nullptr) rawVertical = verticalWheel->getDistanceTraveled();
-    if (horizontalWheel != nullptr) rawHorizontal = horizontalWheel->getDistanceTraveled();
-    float horizontalOffset = 0;
-    float verticalOffset = 0;
-    if (verticalWheel != nullptr) verticalOffset = verticalWheel->getOffset();
-    if (horizontalWheel != nullptr) horizontalOffset = horizontalWheel->getOffset();
+    TrackingWheel* verticalWheel = nullptr;
+    if (sensors.vertical1 != nullptr && !sensors.vertical1->getType()) {
+        verticalWheel = sensors.vertical1;
+        verticalReading = &SensorSnapshot_t::vertical1;
+        verticalVelocity = &SensorSnapshot_t::vertical1Velocity;
+    } else if (sensors.vertical2 != nullptr && !sensors.vertical2->getType()) {
+        verticalWheel = sensors.vertical2;
+        verticalReading = &SensorSnapshot_t::vertical2;
+        verticalVelocity = &SensorSnapshot_t::vertical2Velocity;
+    } else if (sensors.vertical1 != nullptr) {
+        verticalWheel = sensors.vertical1;
+        verticalReading = &SensorSnapshot_t::vertical1;
+        verticalVelocity = &SensorSnapshot_t::vertical1Velocity;
+    } else if (sensors.vertical2 != nullptr) {
+        verticalWheel = sensors.vertical2;
+        verticalReading = &SensorSnapshot_t::vertical2;
+        verticalVelocity = &SensorSnapshot_t::vertical2Velocity;
+    }
+    TrackingWheel* horizontalWheel = nullptr;
+    if (sensors.horizontal1 != nullptr) {
+        horizontalWheel = sensors.horizontal1;
+        horizontalReading = &SensorSnapshot_t::horizontal1;
+        horizontalVelocity = &SensorSnapshot_t::horizontal1Velocity;
+    } else if (sensors.horizontal2 != nullptr) {
+        horizontalWheel = sensors.horizontal2;
+        horizontalReading = &SensorSnapshot_t::horizontal2;
+        horizontalVelocity = &SensorSnapshot_t::horizontal2Velocity;
+    }
+    // a missing wheel is scaled to 0 rather than checked every tick
+    verticalScale = (verticalWheel != nullptr) ? 1 : 0;
+    horizontalScale = (horizontalWheel != nullptr) ? 1 : 0;
+    verticalOffset = (verticalWheel != nullptr) ? verticalWheel->getOffset() : 0;
+    horizontalOffset = (horizontalWheel != nullptr) ? horizontalWheel->getOffset() : 0;
+    verticalPowered = (verticalWheel != nullptr) ? verticalWheel->getType() : false;
+
+    resolveSlipSources();
+}
+
+/**
+ * @brief Resolve which sources of forward travel slip detection compares
+ *
+ */
+void lemlib::Odometry::resolveSlipSources() {
+    wheelCount = sensorWheelCount;
+    slipSourceCount = 0;
+    driveSeeded = false;
+    if (!slipDetection) return;
+
+    // the unpowered vertical tracking wheel
+    if (verticalScale != 0 && !verticalPowered) {
+        slipReadings[slipSourceCount] = verticalReading;
+        slipVelocities[slipSourceCount] = verticalVelocity;
+        slipOffsets[slipSourceCount] = verticalOffset;
+        slipPowered[slipSourceCount] = false;
+        slipBaseWeights[slipSourceCount] = 1;
+        slipSourceCount++;
+    }
+    float driveWeight = (slipSourceCount > 0) ? slipSettings.drivetrainWeight : 1;
+
+    // the sides of the drivetrain. Reuse the vertical wheels if they already are the drivetrain
+    if (drivetrain.leftMotors != nullptr) {
+        if (sensors.vertical1 != nullptr && sensors.vertical1->getType()) {
+            slipReadings[slipSourceCount] = &SensorSnapshot_t::vertical1;
+            slipVelocities[slipSourceCount] = &SensorSnapshot_t::vertical1Velocity;
+            slipOffsets[slipSourceCount] = sensors.vertical1->getOffset();
+        } else {
+            if (leftDriveWheel == nullptr)
+                leftDriveWheel = new TrackingWheel(drivetrain.leftMotors, drivetrain.wheelDiameter,
+                                                   -(drivetrain.trackWidth / 2), drivetrain.rpm);
+            wheels[wheelCount] = leftDriveWheel;
+            wheelReadings[wheelCount] = &SensorSnapshot_t::leftDrive;
+            wheelVelocities[wheelCount] = &SensorSnapshot_t::leftDriveVelocity;
+            wheelDevices[wheelCount] = SensorDevice::LEFT_DRIVE;
+            wheelCount++;
+            slipReadings[slipSourceCount] = &SensorSnapshot_t::leftDrive;
+            slipVelocities[slipSourceCount] = &SensorSnapshot_t::leftDriveVelocity;
+            slipOffsets[slipSourceCount] = leftDriveWheel->getOffset();
+        }
+        slipPowered[slipSourceCount] = true;
+        slipBaseWeights[slipSourceCount] = driveWeight;
+        slipSourceCount++;
+    }
+    if (drivetrain.rightMotors != nullptr) {
+        if (sensors.vertical2 != nullptr && sensors.vertical2->getType()) {
+            slipReadings[slipSourceCount] = &SensorSnapshot_t::vertical2;
+            slipVelocities[slipSourceCount] = &SensorSnapshot_t::vertical2Velocity;
+            slipOffsets[slipSourceCount] = sensors.vertical2->getOffset();
+        } else {
+            if (rightDriveWheel == nullptr)
+                rightDriveWheel = new TrackingWheel(drivetrain.rightMotors, drivetrain.wheelDiameter,
+                                                    drivetrain.trackWidth / 2, drivetrain.rpm);
+            wheels[wheelCount] = rightDriveWheel;
+            wheelReadings[wheelCount] = &SensorSnapshot_t::rightDrive;
+            wheelVelocities[wheelCount] = &SensorSnapshot_t::rightDriveVelocity;
+            wheelDevices[wheelCount] = SensorDevice::RIGHT_DRIVE;
+            wheelCount++;
+            slipReadings[slipSourceCount] = &SensorSnapshot_t::rightDrive;
+            slipVelocities[slipSourceCount] = &SensorSnapshot_t::rightDriveVelocity;
+            slipOffsets[slipSourceCount] = rightDriveWheel->getOffset();
+        }
+        slipPowered[slipSourceCount] = true;
+        slipBaseWeights[slipSourceCount] = driveWeight;
+        slipSourceCount++;
+    }
+    for (int i = 0; i < slipSourceCount; i++) slipWeights[i] = slipBaseWeights[i];
+}
+
+/**
+ * @brief Calculate the forward travel of the robot, weighting down sources that are slipping
+ *
+ * @param snapshot the sensor readings for this tick
+ * @param deltaHeading the change in heading this tick
+ * @return float forward travel of the center of the robot in inches
+ */
+float lemlib::Odometry::slipCorrectedTravel(const SensorSnapshot_t& snapshot, float deltaHeading) {
+    // forward travel of the center of the robot according to each source
+    float travel[3] = {};
+    for (int i = 0; i < slipSourceCount; i++)
+        travel[i] = snapshot.*slipReadings[i] - prevSnapshot.*slipReadings[i] + slipOffsets[i] * deltaHeading;
+
+    // the median of 3 sources, or the smaller of 2 since slipping wheels overread
+    float reference = 0;
+    if (slipSourceCount >= 3)
+        reference = std::max(std::min(travel[0], travel[1]), std::min(std::max(travel[0], travel[1]), travel[2]));
+    else reference = (std::fabs(travel[0]) < std::fabs(travel[1])) ? travel[0] : travel[1];
+
+    // weight down sources that disagree, and the drivetrain during an impact
+    impact = snapshot.imuAccel > slipSettings.impactThreshold;
+    float sum = 0;
+    float weightSum = 0;
+    for (int i = 0; i < slipSourceCount; i++) {
+        if (std::fabs(travel[i] - reference) > slipSettings.slipThreshold || (impact && slipPowered[i]))
+            slipWeights[i] = 0;
+        else slipWeights[i] = std::min(slipBaseWeights[i], slipWeights[i] + slipSettings.recoveryRate);
+        sum += slipWeights[i] * travel[i];
+        weightSum += slipWeights[i];
+    }
+    if (weightSum == 0) return reference;
+    return sum / weightSum;
+}
+
+/**
+ * @brief Calculate the forward velocity of the robot, using the weights slip detection chose this tick
+ *
+ * @param snapshot the sensor readings for this tick
+ * @param angularVelocity the angular velocity in radians per second
+ * @return float forward velocity of the center of the robot in inches per second
+ */
+float lemlib::Odometry::slipCorrectedVelocity(const SensorSnapshot_t& snapshot, float angularVelocity) {
+    float sum = 0;
+    float weightSum = 0;
+    for (int i = 0; i < slipSourceCount; i++) {
+        sum += slipWeights[i] * (snapshot.*slipVelocities[i] + slipOffsets[i] * angularVelocity);
+        weightSum += slipWeights[i];
+    }
+    // every source is slipping, so fall back to the vertical tracking wheel
+    if (weightSum == 0) return verticalScale * snapshot.*verticalVelocity + verticalOffset * angularVelocity;
+    return sum / weightSum;
+}
+
+/**
+ * @brief Get the microseconds since a timestamp, and move the timestamp to now
+ *
+ * @param start the timestamp in microseconds
+ * @return std::uint32_t
+ */
+static std::uint32_t lapMicros(std::uint32_t& start) {
+    std::uint32_t now = pros::micros();
+    std::uint32_t elapsed = now - start;
+    start = now;
+    return elapsed;
+}
+
+/**
+ * @brief Read every configured sensor once
+ *
+ * @return SensorSnapshot_t the sensor readings
+ */
+lemlib::SensorSnapshot_t lemlib::Odometry::sample() {
+    // only read the clock if reads are being timed
+    std::uint32_t sampleStart = latencyTracking ? pros::micros() : 0;
+    std::uint32_t start = sampleStart;
+    SensorSnapshot_t snapshot = {};
+    snapshot.time = pros::millis();
+    float dt = (prevSnapshot.time == 0) ? 0 : (snapshot.time - prevSnapshot.time) / 1000.0;
+    for (int i = 0; i < wheelCount; i++) {
+        float position = wheels[i]->getDistanceTraveled();
+        snapshot.*wheelReadings[i] = position;
+        snapshot.*wheelVelocities[i] = wheels[i]->updateVelocity(position, dt);
+        if (latencyTracking) latency[int(wheelDevices[i])].record(lapMicros(start));
+    }
+    if (imuCount == 1) {
+        snapshot.imu = degToRad(sensors.imu->get_rotation());
+        if (latencyTracking) latency[int(SensorDevice::IMU1)].record(lapMicros(start));
+    } else if (imuCount > 1) {
+        // the robot is stationary if none of the tracking wheels moved
+        bool stationary = true;
+        for (int i = 0; i < sensorWheelCount; i++) {
+            float delta = snapshot.*wheelReadings[i] - prevSnapshot.*wheelReadings[i];
+            if (std::fabs(delta) > 0.001) stationary = false;
+        }
+        if (latencyTracking) start = pros::micros();
+        for (int i = 0; i < imuCount; i++) {
+            snapshot.imus[i] = degToRad(imus[i]->get_rotation());
+            if (latencyTracking) latency[int(SensorDevice::IMU1) + i].record(lapMicros(start));
+        }
+        snapshot.imu = fusion.update(snapshot.imus, imuCount, dt, stationary);
+    }
+    if (slipDetection && sensors.imu != nullptr) {
+        if (latencyTracking) start = pros::micros();
+        pros::c::imu_accel_s_t accel = sensors.imu->get_accel();
+        snapshot.imuAccel = std::hypot(accel.x, accel.y);
+        if (latencyTracking) latency[int(SensorDevice::IMU_ACCEL)].record(lapMicros(start));
+    }
+    if (latencyTracking) latency[int(SensorDevice::SAMPLE)].record(pros::micros() - sampleStart);
+    return snapshot;
+}
+
+/**
+ * @brief Update the pose using a sensor snapshot
+ *
+ * @param snapshot the sensor readings for this tick
+ */
+void lemlib::Odometry::update(const SensorSnapshot_t& snapshot) {
+    // TODO: add particle filter
+    this->snapshot = snapshot;
+
+    // the first snapshot is only the starting point, so readings from before the estimator started aren't motion
+    if (!seeded) {
+        prevSnapshot = snapshot;
+        seeded = true;
+        driveSeeded = true;
+    }
+    // the drivetrain tracking wheels are only sampled once slip detection is enabled
+    if (!driveSeeded) {
+        prevSnapshot.leftDrive = snapshot.leftDrive;
+        prevSnapshot.rightDrive = snapshot.rightDrive;
+        driveSeeded = true;
+    }
+
+    // calculate the change in heading
+    float deltaHeading = 0;
+    if (headingSource == HeadingSource::IMU) {
+        deltaHeading = headingScale * (snapshot.imu - prevSnapshot.imu);
+    } else {
+        float deltaA = snapshot.*headingA - prevSnapshot.*headingA;
+        float deltaB = snapshot.*headingB - prevSnapshot.*headingB;
+        deltaHeading = headingScale * (deltaA - deltaB);
+    }
 
     // calculate change in x and y
-    float deltaX = 0;
-    float deltaY = 0;
-    if (verticalWheel != nullptr) deltaY = rawVertical - prevVertical;
-    if (horizontalWheel != nullptr) deltaX = rawHorizontal - prevHorizontal;
-    prevVertical = rawVertical;
-    prevHorizontal = rawHorizontal;
+    float deltaX = horizontalScale * (snapshot.*horizontalReading - prevSnapshot.*horizontalReading);
+    float deltaY = verticalScale * (snapshot.*verticalReading - prevSnapshot.*verticalReading);
+    if (slipSourceCount >= 2) deltaY = slipCorrectedTravel(snapshot, deltaHeading) - deltaHeading * verticalOffset;
 
     // calculate local x and y
     float localX = 0;
@@ -164,11 +440,453 @@ void lemlib::update() {
     }
 
     // calculate global x and y
-    odomPose.x += localY * sin(avgHeading);
-    odomPose.y += localY * cos(avgHeading);
-    odomPose.x += localX * -cos(avgHeading);
-    odomPose.y += localX * sin(avgHeading);
-    odomPose.theta = heading;
+    if (doublePrecision) {
+        double avgHeading = accumulatedTheta + deltaHeading / 2.0;
+        accumulatedX += localY * std::sin(avgHeading) - localX * std::cos(avgHeading);
+        accumulatedY += localY * std::cos(avgHeading) + localX * std::sin(avgHeading);
+        accumulatedTheta += deltaHeading;
+        pose = Pose(accumulatedX, accumulatedY, accumulatedTheta);
+    } else {
+        float avgHeading = pose.theta + deltaHeading / 2;
+        pose.x += localY * sin(avgHeading);
+        pose.y += localY * cos(avgHeading);
+        pose.x += localX * -cos(avgHeading);
+        pose.y += localX * sin(avgHeading);
+        pose.theta += deltaHeading;
+    }
+
+    // blend part of the pending correction into the pose. Never wait for the lock, the rest is applied next tick
+    if (correctionMutex.take(0)) {
+        float stepX = pendingX * correctionRate;
+        float stepY = pendingY * correctionRate;
+        pendingX -= stepX;
+        pendingY -= stepY;
+        correctionMutex.give();
+        pose.x += stepX;
+        pose.y += stepY;
+        accumulatedX += stepX;
+        accumulatedY += stepY;
+        appliedX += stepX;
+        appliedY += stepY;
+    }
+
+    // update the velocity and acceleration estimates. The tracking wheels measure their velocity, so the filters
+    // smooth the measured velocity of the robot. The IMU only measures rotation, so the heading is differentiated
+    float dt = (prevSnapshot.time == 0) ? 0 : (snapshot.time - prevSnapshot.time) / 1000.0;
+    float angularVelocity = (dt > 0) ? deltaHeading / dt : 0;
+    if (headingSource == HeadingSource::IMU) {
+        thetaFilter.update(pose.theta, dt);
+    } else {
+        angularVelocity = headingScale * (snapshot.*headingVelocityA - snapshot.*headingVelocityB);
+        thetaFilter.update(pose.theta, angularVelocity, dt);
+    }
+    float localVelocityX = horizontalScale * snapshot.*horizontalVelocity + horizontalOffset * angularVelocity;
+    float localVelocityY = verticalScale * snapshot.*verticalVelocity + verticalOffset * angularVelocity;
+    if (slipSourceCount >= 2) localVelocityY = slipCorrectedVelocity(snapshot, angularVelocity);
+    xFilter.update(pose.x - appliedX,
+                   localVelocityY * std::sin(pose.theta) - localVelocityX * std::cos(pose.theta), dt);
+    yFilter.update(pose.y - appliedY,
+                   localVelocityY * std::cos(pose.theta) + localVelocityX * std::sin(pose.theta), dt);
+
+    prevSnapshot = snapshot;
+
+    if (relocalizer != nullptr && !impact) relocalizer->relocalize(*this);
+}
+
+/**
+ * @brief Sample the sensors and update the pose
+ *
+ */
+void lemlib::Odometry::update() { update(sample()); }
+
+/**
+ * @brief Get the pose
+ *
+ * @param radians true for theta in radians, false for degrees. False by default
+ * @return Pose
+ */
+lemlib::Pose lemlib::Odometry::getPose(bool radians) {
+    if (radians) return pose;
+    else return Pose(pose.x, pose.y, radToDeg(pose.theta));
+}
+
+/**
+ * @brief Get the pose the robot is expected to be at after some time
+ *
+ * @param dtMs how far ahead to predict, in milliseconds
+ * @param radians true for theta in radians, false for degrees. False by default
+ * @return Pose
+ */
+lemlib::Pose lemlib::Odometry::getPredictedPose(float dtMs, bool radians) {
+    float dt = dtMs / 1000;
+    Pose velocity = getVelocity(true, true);
+    // integrate the constant robot-frame twist with the exponential map
+    float deltaHeading = velocity.theta * dt;
+    float half = deltaHeading / 2;
+    float chord = 0;
+    if (std::fabs(half) < 0.01) chord = 1 - half * half / 6 + half * half * half * half / 120;
+    else chord = sin(half) / half;
+    float localX = chord * velocity.x * dt;
+    float localY = chord * velocity.y * dt;
+    float avgHeading = pose.theta + half;
+    Pose predicted(pose.x + localX * cos(avgHeading) + localY * sin(avgHeading),
+                   pose.y - localX * sin(avgHeading) + localY * cos(avgHeading), pose.theta + deltaHeading);
+    if (!radians) predicted.theta = radToDeg(predicted.theta);
+    return predicted;
+}
+
+/**
+ * @brief Set the pose
+ *
+ * Takes the tracking lock, so the tracking task can't overwrite the new pose with one it was still calculating
+ *
+ * @param pose the new pose
+ * @param radians true if theta is in radians, false if in degrees. False by default
+ */
+void lemlib::Odometry::setPose(Pose pose, bool radians) {
+    trackingMutex.take(TIMEOUT_MAX);
+    if (radians) this->pose = pose;
+    else this->pose = Pose(pose.x, pose.y, degToRad(pose.theta));
+    accumulatedX = this->pose.x;
+    accumulatedY = this->pose.y;
+    accumulatedTheta = this->pose.theta;
+    // corrections made before the pose was set no longer apply
+    correctionMutex.take(TIMEOUT_MAX);
+    pendingX = 0;
+    pendingY = 0;
+    correctionMutex.give();
+    appliedX = 0;
+    appliedY = 0;
+    // the pose jumped, so the estimators shouldn't see it as motion
+    xFilter.reset(this->pose.x);
+    yFilter.reset(this->pose.y);
+    thetaFilter.reset(this->pose.theta);
+    trackingMutex.give();
+}
+
+/**
+ * @brief Shift the x and y of the pose
+ *
+ * @param dx shift in the x direction in inches
+ * @param dy shift in the y direction in inches
+ */
+void lemlib::Odometry::correct(float dx, float dy) {
+    correctionMutex.take(TIMEOUT_MAX);
+    pendingX += dx;
+    pendingY += dy;
+    correctionMutex.give();
+}
+
+/**
+ * @brief Get the part of the corrections that hasn't been blended into the pose yet
+ *
+ * @return Pose the remaining shift. Theta is always 0
+ */
+lemlib::Pose lemlib::Odometry::getPendingCorrection() {
+    correctionMutex.take(TIMEOUT_MAX);
+    Pose pending(pendingX, pendingY, 0);
+    correctionMutex.give();
+    return pending;
+}
+
+/**
+ * @brief Set how quickly corrections are blended into the pose
+ *
+ * @param rate fraction of the remaining correction applied each tick (0 to 1)
+ */
+void lemlib::Odometry::setCorrectionRate(float rate) { correctionRate = std::clamp(rate, 0.0f, 1.0f); }
+
+/**
+ * @brief Set a relocalizer to correct the pose every tick
+ *
+ * @param relocalizer the relocalizer to run, or nullptr to stop
+ */
+void lemlib::Odometry::setRelocalizer(WallRelocalizer* relocalizer) { this->relocalizer = relocalizer; }
+
+/**
+ * @brief Set whether the pose is accumulated in double precision
+ *
+ * @param enabled true to accumulate the pose in double precision. False by default
+ */
+void lemlib::Odometry::setDoublePrecision(bool enabled) {
+    doublePrecision = enabled;
+    accumulatedX = pose.x;
+    accumulatedY = pose.y;
+    accumulatedTheta = pose.theta;
+}
+
+/**
+ * @brief Enable or disable slip and impact detection
+ *
+ * @param enabled whether slip detection should be enabled
+ * @param settings the slip detection settings
+ */
+void lemlib::Odometry::setSlipDetection(bool enabled, SlipSettings_t settings) {
+    slipDetection = enabled;
+    slipSettings = settings;
+    resolveSlipSources();
+}
+
+/**
+ * @brief Whether any forward travel source is currently weighted down because it slipped
+ *
+ * @return true if a source is slipping
+ */
+bool lemlib::Odometry::isSlipping() {
+    for (int i = 0; i < slipSourceCount; i++) {
+        if (slipWeights[i] < slipBaseWeights[i]) return true;
+    }
+    return false;
+}
+
+/**
+ * @brief Whether the last tick detected an impact
+ *
+ * @return true if the IMU acceleration exceeded the impact threshold
+ */
+bool lemlib::Odometry::isImpact() { return impact; }
+
+/**
+ * @brief Set the settings used to fuse the IMUs. Only used if there are several IMUs
+ *
+ * The fused rotation and the learned bias and scale of each IMU are kept, so this can be called while tracking
+ *
+ * @param settings the fusion settings
+ */
+void lemlib::Odometry::setImuFusion(FusionSettings_t settings) { fusion.setSettings(settings); }
+
+/**
+ * @brief Get the IMU fusion, for example to read the estimated bias of each IMU
+ *
+ * @return ImuFusion&
+ */
+lemlib::ImuFusion& lemlib::Odometry::getImuFusion() { return fusion; }
+
+/**
+ * @brief Set the filter used to estimate velocity and acceleration
+ *
+ * @param settings the filter settings
+ */
+void lemlib::Odometry::setVelocityFilter(FilterSettings_t settings) {
+    xFilter = VelocityFilter(settings);
+    yFilter = VelocityFilter(settings);
+    thetaFilter = VelocityFilter(settings);
+}
+
+/**
+ * @brief Get the velocity
+ *
+ * @param local true for the robot frame (x to the right, y forwards), false for the field frame. False by default
+ * @param radians true for angular velocity in radians per second, false for degrees per second. False by default
+ * @return Pose velocity in inches per second
+ */
+lemlib::Pose lemlib::Odometry::getVelocity(bool local, bool radians) {
+    Pose velocity(xFilter.getVelocity(), yFilter.getVelocity(), thetaFilter.getVelocity());
+    if (local) velocity = velocity.rotate(pose.theta);
+    if (!radians) velocity.theta = radToDeg(velocity.theta);
+    return velocity;
+}
+
+/**
+ * @brief Get the acceleration
+ *
+ * @param local true for the robot frame (x to the right, y forwards), false for the field frame. False by default
+ * @param radians true for angular acceleration in radians per second squared, false for degrees. False by default
+ * @return Pose acceleration in inches per second squared
+ */
+lemlib::Pose lemlib::Odometry::getAcceleration(bool local, bool radians) {
+    Pose acceleration(xFilter.getAcceleration(), yFilter.getAcceleration(), thetaFilter.getAcceleration());
+    if (local) acceleration = acceleration.rotate(pose.theta);
+    if (!radians) acceleration.theta = radToDeg(acceleration.theta);
+    return acceleration;
+}
+
+/**
+ * @brief Get the sensor snapshot used by the last update
+ *
+ * @return SensorSnapshot_t
+ */
+lemlib::SensorSnapshot_t lemlib::Odometry::getSensorSnapshot() { return snapshot; }
+
+/**
+ * @brief Enable or disable timing every sensor read
+ *
+ * @param enabled whether sensor reads should be timed
+ */
+void lemlib::Odometry::setLatencyTracking(bool enabled) { latencyTracking = enabled; }
+
+/**
+ * @brief Get the read latency histogram of a sensor
+ *
+ * @param device the sensor
+ * @return const LatencyHistogram&
+ */
+const lemlib::LatencyHistogram& lemlib::Odometry::getLatency(SensorDevice device) { return latency[int(device)]; }
+
+/**
+ * @brief Clear the read latency histograms of every sensor
+ *
+ */
+void lemlib::Odometry::resetLatency() {
+    for (LatencyHistogram& histogram : latency) histogram.reset();
+}
+
+/**
+ * @brief Log the read latency of every sensor that has been timed
+ *
+ */
+void lemlib::Odometry::logLatency() {
+    const char* names[] = {"vertical1", "vertical2", "horizontal1", "horizontal2", "left drive", "right drive",
+                           "imu1",      "imu2",      "imu3",        "imu4",        "imu accel",  "sample"};
+    for (int i = 0; i <= int(SensorDevice::SAMPLE); i++) {
+        const LatencyHistogram& histogram = latency[i];
+        if (histogram.getCount() == 0) continue;
+        LEMLIB_INFO("%s read latency: mean %.1fus, p50 <%luus, p99 <%luus, max %luus", names[i], histogram.getMean(),
+                    (unsigned long)histogram.getPercentile(50), (unsigned long)histogram.getPercentile(99),
+                    (unsigned long)histogram.getMax());
+    }
+}
+
+/**
+ * @brief Get the heading source chosen for this estimator
+ *
+ * @return HeadingSource
+ */
+lemlib::HeadingSource lemlib::Odometry::getHeadingSource() { return headingSource; }
+
+/**
+ * @brief Set the sensors to be used for odometry
+ *
+ * @param sensors the sensors to be used
+ * @param drivetrain drivetrain to be used
+ */
+void lemlib::setSensors(lemlib::OdomSensors_t sensors, lemlib::Drivetrain_t drivetrain) {
+    // reconfigure in place so the tracking task and getPose() never see a deleted estimator
+    trackingMutex.take(TIMEOUT_MAX);
+    odometry->setSensors(sensors, drivetrain);
+    trackingMutex.give();
+}
+
+/**
+ * @brief Get the primary odometry estimator
+ *
+ * @return Odometry&
+ */
+lemlib::Odometry& lemlib::getOdometry() { return *odometry; }
+
+/**
+ * @brief Run another estimator alongside the primary one
+ *
+ * @param estimator the estimator to add. Must stay alive while odometry is running
+ * @return true if the estimator was added, false if there is no room left
+ */
+bool lemlib::addEstimator(lemlib::Odometry* estimator) {
+    int count = estimatorCount.load();
+    if (count >= 4) return false;
+    estimators[count] = estimator;
+    // publish the estimator only once it is stored, so the tracking task never sees an empty slot
+    estimatorCount.store(count + 1);
+    return true;
+}
+
+/**
+ * @brief Get the pose of the robot
+ *
+ * @param radians true for theta in radians, false for degrees. False by default
+ * @return Pose
+ */
+lemlib::Pose lemlib::getPose(bool radians) { return odometry->getPose(radians); }
+
+/**
+ * @brief Get the pose the robot is expected to be at after some time
+ *
+ * @param dtMs how far ahead to predict, in milliseconds
+ * @param radians true for theta in radians, false for degrees. False by default
+ * @return Pose
+ */
+lemlib::Pose lemlib::getPredictedPose(float dtMs, bool radians) { return odometry->getPredictedPose(dtMs, radians); }
+
+/**
+ * @brief Set the Pose of the robot
+ *
+ * @param pose the new pose
+ * @param radians true if theta is in radians, false if in degrees. False by default
+ */
+void lemlib::setPose(lemlib::Pose pose, bool radians) { odometry->setPose(pose, radians); }
+
+/**
+ * @brief Set the filter used to estimate velocity and acceleration
+ *
+ * @param settings the filter settings
+ */
+void lemlib::setVelocityFilter(lemlib::FilterSettings_t settings) { odometry->setVelocityFilter(settings); }
+
+/**
+ * @brief Get the velocity of the robot
+ *
+ * @param local true for the robot frame (x to the right, y forwards), false for the field frame. False by default
+ * @param radians true for angular velocity in radians per second, false for degrees per second. False by default
+ * @return Pose velocity in inches per second
+ */
+lemlib::Pose lemlib::getVelocity(bool local, bool radians) { return odometry->getVelocity(local, radians); }
+
+/**
+ * @brief Get the acceleration of the robot
+ *
+ * @param local true for the robot frame (x to the right, y forwards), false for the field frame. False by default
+ * @param radians true for angular acceleration in radians per second squared, false for degrees. False by default
+ * @return Pose acceleration in inches per second squared
+ */
+lemlib::Pose lemlib::getAcceleration(bool local, bool radians) { return odometry->getAcceleration(local, radians); }
+
+/**
+ * @brief Get the most recent sensor snapshot used by odometry
+ *
+ * The sensors are only read by the tracking task, once per tick, so this never reads a device
+ *
+ * @return SensorSnapshot_t
+ */
+lemlib::SensorSnapshot_t lemlib::getSensorSnapshot() {
+    // the snapshot is copied under the lock so it isn't torn by the tracking task
+    trackingMutex.take(TIMEOUT_MAX);
+    SensorSnapshot_t snapshot = odometry->getSensorSnapshot();
+    trackingMutex.give();
+    return snapshot;
+}
+
+/**
+ * @brief Update the primary estimator and every added estimator using a sensor snapshot. The tracking lock must be
+ * held
+ *
+ * @param snapshot the sensor readings for this tick
+ */
+static void updateEstimators(const lemlib::SensorSnapshot_t& snapshot) {
+    lemlib::record(snapshot);
+    odometry->update(snapshot);
+    int count = estimatorCount.load();
+    for (int i = 0; i < count; i++) estimators[i]->update(snapshot);
+}
+
+/**
+ * @brief Update the primary estimator and every added estimator using a sensor snapshot
+ *
+ * @param snapshot the sensor readings for this tick
+ */
+void lemlib::update(const lemlib::SensorSnapshot_t& snapshot) {
+    trackingMutex.take(TIMEOUT_MAX);
+    updateEstimators(snapshot);
+    trackingMutex.give();
+}
+
+/**
+ * @brief Sample the sensors and update every estimator
+ *
+ */
+void lemlib::update() {
+    // sample and update under one lock, so the sensors can't be reconfigured in between
+    trackingMutex.take(TIMEOUT_MAX);
+    updateEstimators(odometry->sample());
+    trackingMutex.give();
 }
 
 /**
@@ -209,7 +209,7 @@ void lemlib::Chassis::follow(const char* filePath, int timeout, float lookahead,
     // loop until the robot is within the end tolerance
     for (int i = 0; i < timeout / 10 && pros::competition::get_status() == compState; i++) {
         // get the current position of the robot
-        pose = this->getPose(true);
+        pose = this->getControlPose(true);
         if (reverse) pose.theta -= M_PI;
 
         // find the closest point on the path to the robot
@@ -0,0 +1,181 @@
+/**
+ * @file src/lemlib/chassis/recorder.cpp
+ * @author LemLib Team
+ * @brief Odometry input recording and replay definitions
+ * @version 0.4.5
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include "pros/rtos.hpp"
+#include "lemlib/ringBuffer.hpp"
+#include "lemlib/chassis/recorder.hpp"
+
+// writer thread
+static pros::Task* writerTask = nullptr;
+
+// records waiting to be written. 256 records is 2.5 seconds of odometry
+static lemlib::RingBuffer<lemlib::OdomRecord_t, 256> recordBuffer;
+static std::atomic<std::FILE*> recordFile(nullptr);
+static std::atomic<bool> recording(false);
+static std::atomic<int> droppedRecords(0);
+
+/**
+ * @brief Write queued records to the file in batches, and close the file once recording stops
+ *
+ */
+static void writeRecords() {
+    while (true) {
+        // leave records queued until there is a file to write them to
+        std::FILE* file = recordFile.load();
+        if (file == nullptr) {
+            pros::delay(20);
+            continue;
+        }
+        lemlib::OdomRecord_t batch[32];
+        int count = 0;
+        while (count < 32 && recordBuffer.pop(batch[count])) count++;
+        if (count > 0) {
+            std::size_t written = std::fwrite(batch, sizeof(lemlib::OdomRecord_t), count, file);
+            if (written < std::size_t(count)) droppedRecords += count - written;
+        } else {
+            // everything has been written, close the file if the recording has stopped. A new recording can't start
+            // until the file is closed, so this is always the file that stopped
+            if (!recording.load()) {
+                std::fclose(file);
+                recordFile.store(nullptr);
+            }
+            pros::delay(20);
+        }
+    }
+}
+
+/**
+ * @brief Convert a record back to a sensor snapshot
+ *
+ * @param record the record
+ * @param prevRecord the record of the previous tick. The record itself if it is the first
+ * @return SensorSnapshot_t the sensor readings
+ */
+lemlib::SensorSnapshot_t lemlib::toSnapshot(const OdomRecord_t& record, const OdomRecord_t& prevRecord) {
+    SensorSnapshot_t snapshot = {};
+    snapshot.time = record.time;
+    snapshot.vertical1 = record.vertical1;
+    snapshot.vertical2 = record.vertical2;
+    snapshot.horizontal1 = record.horizontal1;
+    snapshot.horizontal2 = record.horizontal2;
+    snapshot.leftDrive = record.leftDrive;
+    snapshot.rightDrive = record.rightDrive;
+    snapshot.imu = record.imu;
+    snapshot.imuAccel = record.imuAccel;
+    // differentiate the distances. Without time between the records there is nothing to differentiate
+    if (record.time > prevRecord.time) {
+        float dt = (record.time - prevRecord.time) / 1000.0;
+        snapshot.vertical1Velocity = (record.vertical1 - prevRecord.vertical1) / dt;
+        snapshot.vertical2Velocity = (record.vertical2 - prevRecord.vertical2) / dt;
+        snapshot.horizontal1Velocity = (record.horizontal1 - prevRecord.horizontal1) / dt;
+        snapshot.horizontal2Velocity = (record.horizontal2 - prevRecord.horizontal2) / dt;
+        snapshot.leftDriveVelocity = (record.leftDrive - prevRecord.leftDrive) / dt;
+        snapshot.rightDriveVelocity = (record.rightDrive - prevRecord.rightDrive) / dt;
+    }
+    return snapshot;
+}
+
+/**
+ * @brief Start recording the odometry inputs of every tick to a file
+ *
+ * @param filePath file path to the recording. No need to preface it with /usd/
+ * @return true if the recording started, false if a recording is still being written or the file couldn't be opened
+ */
+bool lemlib::startRecording(const char* filePath) {
+    if (recording.load() || recordFile.load() != nullptr) return false;
+    std::FILE* file = std::fopen(("/usd/" + std::string(filePath)).c_str(), "wb");
+    if (file == nullptr) return false;
+    RecordingHeader_t header;
+    std::memcpy(header.magic, "LLOR", 4);
+    header.version = RECORDING_VERSION;
+    header.recordSize = sizeof(OdomRecord_t);
+    std::fwrite(&header, sizeof(header), 1, file);
+    droppedRecords.store(0);
+    // start recording before publishing the file, so the writer never sees the new file with recording stopped
+    recording.store(true);
+    recordFile.store(file);
+    if (writerTask == nullptr)
+        writerTask = new pros::Task {[=] { writeRecords(); }, TASK_PRIORITY_MIN, TASK_STACK_DEPTH_DEFAULT, "recorder"};
+    return true;
+}
+
+/**
+ * @brief Stop recording. Queued records are still written before the file is closed
+ *
+ */
+void lemlib::stopRecording() { recording.store(false); }
+
+/**
+ * @brief Queue the raw inputs of a sensor snapshot to be recorded. Does nothing if not recording
+ *
+ * @param snapshot the sensor readings
+ */
+void lemlib::record(const SensorSnapshot_t& snapshot) {
+    if (!recording.load(std::memory_order_relaxed)) return;
+    OdomRecord_t record = {snapshot.time, snapshot.vertical1, snapshot.vertical2, snapshot.horizontal1,
+                           snapshot.horizontal2, snapshot.leftDrive, snapshot.rightDrive, snapshot.imu,
+                           snapshot.imuAccel};
+    if (!recordBuffer.push(record)) droppedRecords++;
+}
+
+/**
+ * @brief Get the number of records dropped because the queue was full or the file couldn't be written
+ *
+ * @return int
+ */
+int lemlib::getDroppedRecords() { return droppedRecords.load(); }
+
+/**
+ * @brief Feed a recording through an estimator as fast as possible
+ *
+ * @param filePath file path to the recording. No need to preface it with /usd/
+ * @param estimator the estimator to update
+ * @return int the number of records replayed, or -1 if the file couldn't be read
+ */
+int lemlib::replay(const char* filePath, Odometry& estimator) {
+    std::FILE* file = std::fopen(("/usd/" + std::string(filePath)).c_str(), "rb");
+    if (file == nullptr) return -1;
+    int total = replay(file, estimator);
+    std::fclose(file);
+    return total;
+}
+
+/**
+ * @brief Feed a recording through an estimator as fast as possible
+ *
+ * @param file the recording, opened for reading in binary mode. Not closed
+ * @param estimator the estimator to update
+ * @return int the number of records replayed, or -1 if the file isn't a recording
+ */
+int lemlib::replay(std::FILE* file, Odometry& estimator) {
+    RecordingHeader_t header;
+    if (std::fread(&header, sizeof(header), 1, file) != 1 || std::memcmp(header.magic, "LLOR", 4) != 0 ||
+        header.version != RECORDING_VERSION || header.recordSize != sizeof(OdomRecord_t)) {
+        return -1;
+    }
+    // read in batches to keep the number of file system calls down
+    OdomRecord_t batch[32];
+    OdomRecord_t prevRecord;
+    int total = 0;
+    std::size_t count = 0;
+    while ((count = std::fread(batch, sizeof(OdomRecord_t), 32, file)) > 0) {
+        for (std::size_t i = 0; i < count; i++) {
+            estimator.update(toSnapshot(batch[i], (total == 0 && i == 0) ? batch[i] : prevRecord));
+            prevRecord = batch[i];
+        }
+        total += count;
+    }
+    return total;
+}
@@ -0,0 +1,109 @@
+/**
+ * @file src/lemlib/chassis/relocalize.cpp
+ * @author LemLib Team
+ * @brief Distance sensor wall relocalization definitions
+ * @version 0.4.5
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#include <math.h>
+#include "lemlib/util.hpp"
+#include "lemlib/chassis/odom.hpp"
+#include "lemlib/chassis/relocalize.hpp"
+
+/**
+ * @brief Construct a new Wall Relocalizer
+ *
+ * @param sensors the distance sensors and where they are mounted
+ * @param settings the relocalization settings
+ */
+lemlib::WallRelocalizer::WallRelocalizer(std::vector<DistanceSensor_t> sensors, RelocalizeSettings_t settings)
+    : sensors(sensors),
+      settings(settings) {
+    minNormal = cos(degToRad(settings.maxIncidence));
+    // precompute the field-frame ray of every sensor for every degree of heading. The last entry of each sensor
+    // duplicates the first so lookups can always interpolate with the next entry
+    table.resize(sensors.size() * (BINS + 1));
+    for (std::size_t i = 0; i < sensors.size(); i++) {
+        for (int bin = 0; bin <= BINS; bin++) {
+            float heading = degToRad(bin * 360.0 / BINS);
+            float direction = heading + degToRad(sensors[i].angle);
+            RayEntry_t& entry = table[i * (BINS + 1) + bin];
+            entry.directionX = sin(direction);
+            entry.directionY = cos(direction);
+            entry.offsetX = sensors[i].x * cos(heading) + sensors[i].y * sin(heading);
+            entry.offsetY = -sensors[i].x * sin(heading) + sensors[i].y * cos(heading);
+        }
+    }
+}
+
+/**
+ * @brief Correct the pose of an estimator once
+ *
+ * @param odometry the estimator to correct
+ * @return true if at least one sensor was used for a correction
+ */
+bool lemlib::WallRelocalizer::relocalize(Odometry& odometry) {
+    // work from the pose the estimator will have once the corrections still pending are applied
+    Pose pose = odometry.getPose();
+    Pose pending = odometry.getPendingCorrection();
+    pose.x += pending.x;
+    pose.y += pending.y;
+    // find the heading bins to interpolate between
+    float heading = fmod(pose.theta, 360);
+    if (heading < 0) heading += 360;
+    float position = heading * BINS / 360;
+    int bin = position;
+    if (bin >= BINS) bin = BINS - 1;
+    float t = position - bin;
+
+    float halfField = settings.fieldSize / 2;
+    float sumX = 0, sumY = 0;
+    int countX = 0, countY = 0;
+    for (std::size_t i = 0; i < sensors.size(); i++) {
+        // read the sensor first, and skip it if it can't be trusted
+        int reading = sensors[i].sensor->get();
+        if (reading <= 0 || reading == PROS_ERR) continue;
+        float distance = reading / 25.4;
+        if (distance > settings.maxDistance) continue;
+        // confidence is only reported above 200mm
+        if (reading > 200 && sensors[i].sensor->get_confidence() < settings.minConfidence) continue;
+
+        // look up the ray of the sensor at this heading
+        const RayEntry_t& a = table[i * (BINS + 1) + bin];
+        const RayEntry_t& b = table[i * (BINS + 1) + bin + 1];
+        float ux = a.directionX + (b.directionX - a.directionX) * t;
+        float uy = a.directionY + (b.directionY - a.directionY) * t;
+        float px = pose.x + a.offsetX + (b.offsetX - a.offsetX) * t;
+        float py = pose.y + a.offsetY + (b.offsetY - a.offsetY) * t;
+
+        // cast the ray against the walls it points towards, and keep the closest hit
+        float hitX = INFINITY, hitY = INFINITY;
+        if (ux > 0) hitX = (halfField - px) / ux;
+        else if (ux < 0) hitX = (-halfField - px) / ux;
+        if (uy > 0) hitY = (halfField - py) / uy;
+        else if (uy < 0) hitY = (-halfField - py) / uy;
+        bool xWall = hitX < hitY;
+        float expected = xWall ? hitX : hitY;
+        float normal = xWall ? ux : uy;
+        if (expected < 0 || std::fabs(normal) < minNormal) continue;
+        float residual = distance - expected;
+        if (std::fabs(residual) > settings.maxResidual) continue;
+
+        // the robot is further from the wall than expected if the residual is positive, so move it away from the wall
+        if (xWall) {
+            sumX -= residual * normal;
+            countX++;
+        } else {
+            sumY -= residual * normal;
+            countY++;
+        }
+    }
+
+    if (countX == 0 && countY == 0) return false;
+    odometry.correct(countX > 0 ? sumX / countX : 0, countY > 0 ? sumY / countY : 0);
+    return true;
+}
@@ -13,6 +13,7 @@
 #include "lemlib/chassis/trackingWheel.hpp"
 #include "lemlib/util.hpp"
 #include "pros/llemu.hpp"
+#include "pros/rtos.hpp"
 
 /**
  * @brief Create a new tracking wheel
@@ -23,10 +24,12 @@
  * @param gearRatio gear ratio of the tracking wheel, defaults to 1
  */
 lemlib::TrackingWheel::TrackingWheel(pros::ADIEncoder* encoder, float diameter, float distance, float gearRatio) {
+    this->device = Device::ADI_ENCODER;
     this->encoder = encoder;
-    this->diameter = diameter;
+    this->scale = diameter * M_PI / (EncoderPolicy<pros::ADIEncoder>::UNITS_PER_ROTATION * gearRatio);
+    this->powered = EncoderPolicy<pros::ADIEncoder>::POWERED;
+    this->velocitySmoothing = EncoderPolicy<pros::ADIEncoder>::VELOCITY_SMOOTHING;
     this->distance = distance;
-    this->gearRatio = gearRatio;
 }
 
 /**
@@ -38,10 +41,12 @@ lemlib::TrackingWheel::TrackingWheel(pros::ADIEncoder* encoder, float diameter,
  * @param gearRatio gear ratio of the tracking wheel, defaults to 1
  */
 lemlib::TrackingWheel::TrackingWheel(pros::Rotation* encoder, float diameter, float distance, float gearRatio) {
+    this->device = Device::ROTATION;
     this->rotation = encoder;
-    this->diameter = diameter;
+    this->scale = diameter * M_PI / (EncoderPolicy<pros::Rotation>::UNITS_PER_ROTATION * gearRatio);
+    this->powered = EncoderPolicy<pros::Rotation>::POWERED;
+    this->velocitySmoothing = EncoderPolicy<pros::Rotation>::VELOCITY_SMOOTHING;
     this->distance = distance;
-    this->gearRatio = gearRatio;
 }
 
 /**
@@ -53,11 +58,30 @@ lemlib::TrackingWheel::TrackingWheel(pros::Rotation* encoder, float diameter, fl
  * @param rpm theoretical maximum rpm of the drivetrain wheels
  */
 lemlib::TrackingWheel::TrackingWheel(pros::Motor_Group* motors, float diameter, float distance, float rpm) {
-    this->motors = motors;
-    this->motors->set_encoder_units(pros::E_MOTOR_ENCODER_ROTATIONS);
-    this->diameter = diameter;
+    this->device = Device::MOTOR_GROUP;
+    this->motorGroup.emplace(motors, rpm);
+    // the motor group encoder already accounts for the gearing of the motors
+    this->scale = diameter * M_PI / EncoderPolicy<MotorGroupEncoder>::UNITS_PER_ROTATION;
+    this->powered = EncoderPolicy<MotorGroupEncoder>::POWERED;
+    this->velocitySmoothing = EncoderPolicy<MotorGroupEncoder>::VELOCITY_SMOOTHING;
+    this->distance = distance;
+}
+
+/**
+ * @brief Create a new tracking wheel
+ *
+ * @param encoder the mock encoder to use
+ * @param diameter diameter of the tracking wheel in inches
+ * @param distance distance between the tracking wheel and the center of rotation in inches
+ * @param gearRatio gear ratio of the tracking wheel, defaults to 1
+ */
+lemlib::TrackingWheel::TrackingWheel(MockEncoder_t* encoder, float diameter, float distance, float gearRatio) {
+    this->device = Device::MOCK;
+    this->mock = encoder;
+    this->scale = diameter * M_PI / (EncoderPolicy<MockEncoder_t>::UNITS_PER_ROTATION * gearRatio);
+    this->powered = EncoderPolicy<MockEncoder_t>::POWERED;
+    this->velocitySmoothing = EncoderPolicy<MockEncoder_t>::VELOCITY_SMOOTHING;
     this->distance = distance;
-    this->rpm = rpm;
 }
 
 /**
@@ -65,9 +89,15 @@ lemlib::TrackingWheel::TrackingWheel(pros::Motor_Group* motors, float diameter,
  *
  */
 void lemlib::TrackingWheel::reset() {
-    if (this->encoder != nullptr) this->encoder->reset();
-    if (this->rotation != nullptr) this->rotation->reset_position();
-    if (this->motors != nullptr) this->motors->tare_position();
+    switch (this->device) {
+        case Device::ADI_ENCODER: EncoderPolicy<pros::ADIEncoder>::reset(this->encoder); break;
+        case Device::ROTATION: EncoderPolicy<pros::Rotation>::reset(this->rotation); break;
+        case Device::MOTOR_GROUP: EncoderPolicy<MotorGroupEncoder>::reset(&*this->motorGroup); break;
+        case Device::MOCK: EncoderPolicy<MockEncoder_t>::reset(this->mock); break;
+    }
+    this->velocity = 0;
+    this->prevPosition = 0;
+    this->hasPrevPosition = false;
 }
 
 /**
@@ -76,29 +106,42 @@ void lemlib::TrackingWheel::reset() {
  * @return float distance traveled in inches
  */
 float lemlib::TrackingWheel::getDistanceTraveled() {
-    if (this->encoder != nullptr) {
-        return (float(this->encoder->get_value()) * this->diameter * M_PI / 360) / this->gearRatio;
-    } else if (this->rotation != nullptr) {
-        return (float(this->rotation->get_position()) * this->diameter * M_PI / 36000) / this->gearRatio;
-    } else if (this->motors != nullptr) {
-        // get distance traveled by each motor
-        std::vector<pros::motor_gearset_e_t> gearsets = this->motors->get_gearing();
-        std::vector<double> positions = this->motors->get_positions();
-        std::vector<float> distances;
-        for (int i = 0; i < this->motors->size(); i++) {
-            float in;
-            switch (gearsets[i]) {
-                case pros::E_MOTOR_GEARSET_36: in = 100; break;
-                case pros::E_MOTOR_GEARSET_18: in = 200; break;
-                case pros::E_MOTOR_GEARSET_06: in = 600; break;
-                default: in = 200; break;
-            }
-            distances.push_back(positions[i] * (diameter * M_PI) * (rpm / in));
+    switch (this->device) {
+        case Device::ADI_ENCODER: return EncoderPolicy<pros::ADIEncoder>::read(this->encoder) * this->scale;
+        case Device::ROTATION: return EncoderPolicy<pros::Rotation>::read(this->rotation) * this->scale;
+        case Device::MOTOR_GROUP: return EncoderPolicy<MotorGroupEncoder>::read(&*this->motorGroup) * this->scale;
+        case Device::MOCK: return EncoderPolicy<MockEncoder_t>::read(this->mock) * this->scale;
+    }
+    return 0;
+}
+
+/**
+ * @brief Update the velocity of the tracking wheel. Called once per odometry tick
+ *
+ * @param position the distance traveled read this tick, in inches
+ * @param dt time since the last tick in seconds. 0 if there was no last tick
+ * @return float velocity in inches per second
+ */
+float lemlib::TrackingWheel::updateVelocity(float position, float dt) {
+    float measured = 0;
+    switch (this->device) {
+        case Device::ROTATION: measured = EncoderPolicy<pros::Rotation>::velocity(this->rotation); break;
+        case Device::MOTOR_GROUP: measured = EncoderPolicy<MotorGroupEncoder>::velocity(&*this->motorGroup); break;
+        case Device::MOCK: measured = EncoderPolicy<MockEncoder_t>::velocity(this->mock); break;
+        case Device::ADI_ENCODER: {
+            // optical shaft encoders don't measure their velocity, so differentiate the position. Without a previous
+            // tick there is nothing to differentiate
+            bool valid = this->hasPrevPosition && dt > 0;
+            if (valid) measured = (position - this->prevPosition) / dt;
+            this->prevPosition = position;
+            this->hasPrevPosition = true;
+            if (!valid) return this->velocity;
+            this->velocity += (measured - this->velocity) * this->velocitySmoothing;
+            return this->velocity;
         }
-        return lemlib::avg(distances);
-    } else {
-        return 0;
     }
+    this->velocity += (measured * this->scale - this->velocity) * this->velocitySmoothing;
+    return this->velocity;
 }
 
 /**
@@ -113,7 +156,4 @@ float lemlib::TrackingWheel::getOffset() { return this->distance; }
  *
  * @return int - 1 if motor group, 0 otherwise
  */
-int lemlib::TrackingWheel::getType() {
-    if (this->motors != nullptr) return 1;
-    return 0;
-}
+int lemlib::TrackingWheel::getType() { return this->powered; }
@@ -0,0 +1,59 @@
+/**
+ * @file src/lemlib/clock.cpp
+ * @author LemLib Team
+ * @brief Clock interface definitions
+ * @version 0.4.5
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#include "pros/rtos.hpp"
+#include "lemlib/clock.hpp"
+
+/**
+ * @brief Get the milliseconds since PROS initialized
+ *
+ * @return std::uint32_t time in milliseconds
+ */
+std::uint32_t lemlib::SystemClock::millis() { return pros::c::millis(); }
+
+/**
+ * @brief Construct a new Manual Clock
+ *
+ * @param time the starting time in milliseconds
+ */
+lemlib::ManualClock::ManualClock(std::uint32_t time)
+    : time(time) {}
+
+/**
+ * @brief Get the current time
+ *
+ * @return std::uint32_t time in milliseconds
+ */
+std::uint32_t lemlib::ManualClock::millis() { return time; }
+
+/**
+ * @brief Set the current time
+ *
+ * @param time the new time in milliseconds
+ */
+void lemlib::ManualClock::setTime(std::uint32_t time) { this->time = time; }
+
+/**
+ * @brief Move the current time forwards
+ *
+ * @param dt how far to move the time in milliseconds
+ */
+void lemlib::ManualClock::advance(std::uint32_t dt) { time += dt; }
+
+/**
+ * @brief Get the clock that reads the time of the brain. Used by default
+ *
+ * @return Clock&
+ */
+lemlib::Clock& lemlib::getSystemClock() {
+    static SystemClock clock;
+    return clock;
+}
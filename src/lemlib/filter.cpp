@@ -0,0 +1,198 @@
+/**
+ * @file src/lemlib/filter.cpp
+ * @author LemLib Team
+ * @brief Velocity and acceleration filter definitions
+ * @version 0.4.5
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#include "lemlib/filter.hpp"
+
+/**
+ * @brief Construct a new Velocity Filter
+ *
+ * @param settings the filter settings
+ */
+lemlib::VelocityFilter::VelocityFilter(FilterSettings_t settings) {
+    if (settings.window < 3) settings.window = 3;
+    if (settings.window > MAX_WINDOW) settings.window = MAX_WINDOW;
+    this->settings = settings;
+
+    // precompute the Savitzky-Golay weights
+    // a quadratic is fit to the samples at t = 0, -1, ..., -(window - 1), where t = 0 is the newest sample,
+    // and its first and second derivatives are evaluated at t = 0
+    int n = settings.window;
+    double s[5] = {0, 0, 0, 0, 0}; // sums of t^0 to t^4
+    for (int i = 0; i < n; i++) {
+        double p = 1;
+        for (int j = 0; j < 5; j++) {
+            s[j] += p;
+            p *= -i;
+        }
+    }
+    // invert the normal matrix [[s0, s1, s2], [s1, s2, s3], [s2, s3, s4]]
+    double det = s[0] * (s[2] * s[4] - s[3] * s[3]) - s[1] * (s[1] * s[4] - s[3] * s[2]) +
+                 s[2] * (s[1] * s[3] - s[2] * s[2]);
+    double inv00 = (s[2] * s[4] - s[3] * s[3]) / det;
+    double inv10 = -(s[1] * s[4] - s[2] * s[3]) / det;
+    double inv11 = (s[0] * s[4] - s[2] * s[2]) / det;
+    double inv12 = -(s[0] * s[3] - s[1] * s[2]) / det;
+    double inv20 = (s[1] * s[3] - s[2] * s[2]) / det;
+    double inv21 = -(s[0] * s[3] - s[2] * s[1]) / det;
+    double inv22 = (s[0] * s[2] - s[1] * s[1]) / det;
+    for (int i = 0; i < n; i++) {
+        double t = -i;
+        // the inverse is symmetric, so the first row is the first column
+        valueWeights[i] = inv00 + inv10 * t + inv20 * t * t;
+        velocityWeights[i] = inv10 + inv11 * t + inv12 * t * t;
+        accelerationWeights[i] = 2 * (inv20 + inv21 * t + inv22 * t * t);
+    }
+}
+
+/**
+ * @brief Add a new position sample
+ *
+ * @param position the new position
+ * @param dt time since the last sample in seconds
+ */
+void lemlib::VelocityFilter::update(float position, float dt) {
+    if (!initialized || measured) {
+        reset(position);
+        return;
+    }
+    if (dt <= 0) return;
+
+    if (settings.type == FilterType::ALPHA_BETA) {
+        // predict
+        float predicted = this->position + velocity * dt + 0.5 * acceleration * dt * dt;
+        float predictedVelocity = velocity + acceleration * dt;
+        // correct
+        float residual = position - predicted;
+        this->position = predicted + settings.alpha * residual;
+        velocity = predictedVelocity + settings.beta * residual / dt;
+        acceleration += 2 * settings.gamma * residual / (dt * dt);
+        return;
+    }
+
+    // store the sample
+    int n = settings.window;
+    float prevPosition = samples[head];
+    head = (head + 1) % n;
+    samples[head] = position;
+    dts[head] = dt;
+    this->position = position;
+    if (count < n) count++;
+
+    // not enough samples for a fit yet, use a finite difference
+    if (count < n) {
+        float prevVelocity = velocity;
+        velocity = (position - prevPosition) / dt;
+        acceleration = (velocity - prevVelocity) / dt;
+        return;
+    }
+
+    // the fit assumes evenly spaced samples, so use the average period over the window
+    float period = 0;
+    for (int age = 0; age < n - 1; age++) period += dts[(head - age + n) % n];
+    period /= n - 1;
+    float v = 0;
+    float a = 0;
+    for (int age = 0; age < n; age++) {
+        float sample = samples[(head - age + n) % n];
+        v += velocityWeights[age] * sample;
+        a += accelerationWeights[age] * sample;
+    }
+    velocity = v / period;
+    acceleration = a / (period * period);
+}
+
+/**
+ * @brief Add a new position sample along with a measured velocity
+ *
+ * @param position the new position
+ * @param velocity the measured velocity
+ * @param dt time since the last sample in seconds
+ */
+void lemlib::VelocityFilter::update(float position, float velocity, float dt) {
+    if (!initialized || !measured) {
+        reset(position);
+        for (int i = 0; i < MAX_WINDOW; i++) samples[i] = velocity;
+        this->velocity = velocity;
+        measured = true;
+        return;
+    }
+    this->position = position;
+    if (dt <= 0) return;
+
+    if (settings.type == FilterType::ALPHA_BETA) {
+        float predictedVelocity = this->velocity + acceleration * dt;
+        float residual = velocity - predictedVelocity;
+        this->velocity = predictedVelocity + settings.alpha * residual;
+        acceleration += settings.beta * residual / dt;
+        return;
+    }
+
+    // store the sample
+    int n = settings.window;
+    head = (head + 1) % n;
+    samples[head] = velocity;
+    dts[head] = dt;
+    if (count < n) count++;
+
+    // not enough samples for a fit yet, use the measurement
+    if (count < n) {
+        acceleration = (velocity - this->velocity) / dt;
+        this->velocity = velocity;
+        return;
+    }
+
+    // fit the velocity samples, so the acceleration is the first derivative of the fit
+    float period = 0;
+    for (int age = 0; age < n - 1; age++) period += dts[(head - age + n) % n];
+    period /= n - 1;
+    float v = 0;
+    float a = 0;
+    for (int age = 0; age < n; age++) {
+        float sample = samples[(head - age + n) % n];
+        v += valueWeights[age] * sample;
+        a += velocityWeights[age] * sample;
+    }
+    this->velocity = v;
+    acceleration = a / period;
+}
+
+/**
+ * @brief Reset the filter to a stationary state
+ *
+ * @param position the current position
+ */
+void lemlib::VelocityFilter::reset(float position) {
+    this->position = position;
+    velocity = 0;
+    acceleration = 0;
+    for (int i = 0; i < MAX_WINDOW; i++) {
+        samples[i] = position;
+        dts[i] = 0;
+    }
+    head = 0;
+    count = 1;
+    initialized = true;
+    measured = false;
+}
+
+/**
+ * @brief Get the estimated velocity
+ *
+ * @return float units per second
+ */
+float lemlib::VelocityFilter::getVelocity() { return velocity; }
+
+/**
+ * @brief Get the estimated acceleration
+ *
+ * @return float units per second squared
+ */
+float lemlib::VelocityFilter::getAcceleration() { return acceleration; }
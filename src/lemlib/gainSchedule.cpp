@@ -0,0 +1,71 @@
+/**
+ * @file src/lemlib/gainSchedule.cpp
+ * @author LemLib Team
+ * @brief Gain schedule definitions
+ * @version 0.4.5
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#include <algorithm>
+#include <math.h>
+#include "lemlib/gainSchedule.hpp"
+
+/**
+ * @brief Construct a new Gain Schedule
+ *
+ * @param points the points of the schedule. Sorted by key automatically
+ * @param key what the schedule is keyed on. ERROR by default
+ */
+lemlib::GainSchedule::GainSchedule(std::vector<GainPoint_t> points, ScheduleKey key)
+    : key(key) {
+    if (points.empty()) points.push_back({0, 1, 1});
+    std::sort(points.begin(), points.end(),
+              [](const GainPoint_t& a, const GainPoint_t& b) { return a.key < b.key; });
+    // the table covers keys from 0 to the last point
+    float maxKey = points.back().key;
+    if (maxKey > 0) {
+        keysPerEntry = maxKey / RESOLUTION;
+        entriesPerKey = RESOLUTION / maxKey;
+    }
+    // resample the piecewise-linear schedule
+    std::size_t segment = 0;
+    for (int i = 0; i <= RESOLUTION; i++) {
+        float k = i * keysPerEntry;
+        while (segment + 1 < points.size() && points[segment + 1].key < k) segment++;
+        const GainPoint_t& a = points[segment];
+        const GainPoint_t& b = points[std::min(segment + 1, points.size() - 1)];
+        float t = (b.key > a.key) ? std::clamp((k - a.key) / (b.key - a.key), 0.0f, 1.0f) : 0;
+        pTable[i] = a.pScale + (b.pScale - a.pScale) * t;
+        dTable[i] = a.dScale + (b.dScale - a.dScale) * t;
+    }
+}
+
+/**
+ * @brief Look up the gain scales
+ *
+ * @param key the error or speed. Only the magnitude is used
+ * @param pScale set to what kP should be multiplied by
+ * @param dScale set to what kD should be multiplied by
+ */
+void lemlib::GainSchedule::lookup(float key, float& pScale, float& dScale) const {
+    float position = std::fabs(key) * entriesPerKey;
+    if (!(position < RESOLUTION)) { // also catches NaN
+        pScale = pTable[RESOLUTION];
+        dScale = dTable[RESOLUTION];
+        return;
+    }
+    int i = position;
+    float t = position - i;
+    pScale = pTable[i] + (pTable[i + 1] - pTable[i]) * t;
+    dScale = dTable[i] + (dTable[i + 1] - dTable[i]) * t;
+}
+
+/**
+ * @brief Get what the schedule is keyed on
+ *
+ * @return ScheduleKey
+ */
+lemlib::ScheduleKey lemlib::GainSchedule::getKey() const { return key; }
@@ -9,24 +9,38 @@
  *
  */
 
-#include <iostream>
-#include <string>
-
+#include <algorithm>
+#include <atomic>
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+
+#include "pros/rtos.hpp"
 #include "lemlib/logger.hpp"
+#include "lemlib/ringBuffer.hpp"
+
+/**
+ * @brief The logger configuration, shared by every file
+ *
+ */
+static std::atomic<bool> debugEnabled {false};
+static std::atomic<bool> verboseEnabled {false};
+static std::atomic<lemlib::logger::Level> lowestLevel {lemlib::logger::Level::INFO};
 
 /**
  * @brief Whether or not to log debug messages.
  *
  * @return true if debug is enabled
  */
-bool lemlib::logger::isDebug() { return lemlib::debug; }
+bool lemlib::logger::isDebug() { return debugEnabled.load(std::memory_order_relaxed); }
 
 /**
- * @brief Sets lemlib::debug
+ * @brief Sets whether debug messages are logged. Shared by every file
  *
  * @param debug the new value
  */
-void lemlib::logger::setDebug(bool debug) { lemlib::debug = debug; }
+void lemlib::logger::setDebug(bool debug) { debugEnabled.store(debug, std::memory_order_relaxed); }
 
 /**
  * @brief Whether or not to log info messages.
@@ -34,39 +48,39 @@ void lemlib::logger::setDebug(bool debug) { lemlib::debug = debug; }
  * If false, only log messages with a level of lemlib::logger::Level::WARN
  * or higher will be logged
  */
-bool lemlib::logger::isVerbose() { return lemlib::verbose; }
+bool lemlib::logger::isVerbose() { return verboseEnabled.load(std::memory_order_relaxed); }
 
 /**
- * @brief Sets lemlib::verbose
+ * @brief Sets whether info messages are logged. Shared by every file
  *
  * @param verbose the new value
  */
-void lemlib::logger::setVerbose(bool verbose) { lemlib::verbose = verbose; }
+void lemlib::logger::setVerbose(bool verbose) { verboseEnabled.store(verbose, std::memory_order_relaxed); }
 
 /**
  * @brief The current lowest log level.
  *
  * @return the lowest loggable level
  */
-lemlib::logger::Level lemlib::logger::getLowestLevel() { return lemlib::logger::lowestLevel; }
+lemlib::logger::Level lemlib::logger::getLowestLevel() { return lowestLevel.load(std::memory_order_relaxed); }
 
 /**
- * @brief Sets the lowest loggable level
+ * @brief Sets the lowest loggable level. Shared by every file
  *
  * @param level the new lowest loggable level
  */
-void lemlib::logger::setLowestLevel(Level level) { lemlib::logger::lowestLevel = level; }
+void lemlib::logger::setLowestLevel(Level level) { lowestLevel.store(level, std::memory_order_relaxed); }
 
 /*
 Util functions for logger.
 Not meant to be used outside of this file.
 */
 
-int ordinal(lemlib::logger::Level level) { return static_cast<int>(level); }
+static int ordinal(lemlib::logger::Level level) { return static_cast<int>(level); }
 
-const std::string RESET_ANSI = "\033[0m";
+static const char* RESET_ANSI = "\033[0m";
 
-std::string getColor(lemlib::logger::Level level) {
+static const char* getColor(lemlib::logger::Level level) {
     switch (level) {
         case lemlib::logger::Level::DEBUG: return "\033[0;36m"; // cyan
         case lemlib::logger::Level::INFO: return "\033[0;32m"; // green
@@ -77,27 +91,148 @@ std::string getColor(lemlib::logger::Level level) {
     }
 }
 
-std::string getFormattedLevel(lemlib::logger::Level level) {
-    const char* name = "";
-
+static const char* getLevelName(lemlib::logger::Level level) {
     switch (level) {
-        case lemlib::logger::Level::DEBUG: name = "DEBUG"; break;
-        case lemlib::logger::Level::INFO: name = "INFO"; break;
-        case lemlib::logger::Level::WARN: name = "WARN"; break;
-        case lemlib::logger::Level::ERROR: name = "ERROR"; break;
-        case lemlib::logger::Level::FATAL: name = "FATAL"; break;
-        default: name = "UNKNOWN"; break;
+        case lemlib::logger::Level::DEBUG: return "DEBUG";
+        case lemlib::logger::Level::INFO: return "INFO";
+        case lemlib::logger::Level::WARN: return "WARN";
+        case lemlib::logger::Level::ERROR: return "ERROR";
+        case lemlib::logger::Level::FATAL: return "FATAL";
+        default: return "UNKNOWN";
     }
+}
+
+
+/**
+ * @brief A message waiting to be printed. Messages longer than the text are truncated
+ *
+ */
+typedef struct {
+        lemlib::logger::Level level;
+        char text[120];
+} LogRecord_t;
+
+static lemlib::MPSCRingBuffer<LogRecord_t, 64> logBuffer;
+static std::atomic<int> droppedMessages {0};
+static std::atomic<bool> flushStarted {false};
+
+/**
+ * @brief Append text to a record, truncating it if it doesn't fit
+ *
+ * @param record the record to append to
+ * @param length the length of the text already in the record
+ * @param text the text to append
+ * @return std::size_t the new length of the text in the record
+ */
+static std::size_t append(LogRecord_t& record, std::size_t length, const char* text) {
+    std::size_t count = std::min(std::strlen(text), sizeof(record.text) - 1 - length);
+    std::memcpy(record.text + length, text, count);
+    record.text[length + count] = '\0';
+    return length + count;
+}
+
+/**
+ * @brief Print a record. Not flushed
+ *
+ * @param record the record to print
+ */
+static void print(const LogRecord_t& record) {
+    std::printf("[LemLib] %s%s: %s%s\n", getColor(record.level), getLevelName(record.level), record.text, RESET_ANSI);
+}
+
+/**
+ * @brief Print the queued messages in batches. Runs in its own low priority task
+ *
+ */
+static void flushMessages() {
+    LogRecord_t record;
+    int reportedDrops = 0;
+    while (true) {
+        int count = 0;
+        while (count < 16 && logBuffer.pop(record)) {
+            print(record);
+            count++;
+        }
+        // report messages that were dropped since the last batch
+        int dropped = droppedMessages.load(std::memory_order_relaxed);
+        if (dropped != reportedDrops) {
+            std::printf("[LemLib] %s%s: %d log messages dropped, the log buffer was full%s\n",
+                        getColor(lemlib::logger::Level::WARN), getLevelName(lemlib::logger::Level::WARN),
+                        dropped - reportedDrops, RESET_ANSI);
+            reportedDrops = dropped;
+            count++;
+        }
+        if (count > 0) std::fflush(stdout);
+        // keep going straight away if the batch was full, there are probably more messages waiting
+        if (count < 16) pros::delay(20);
+    }
+}
 
-    return getColor(level) + name;
+/**
+ * @brief Queue a record to be printed by the flush task, starting the task if needed
+ *
+ * Fatal messages are printed straight away instead, since the program may not survive long enough for the flush
+ * task to print them. They can appear before messages that were queued earlier
+ *
+ * @param record the record to print
+ */
+static void push(const LogRecord_t& record) {
+    if (record.level == lemlib::logger::Level::FATAL) {
+        print(record);
+        std::fflush(stdout);
+        return;
+    }
+    if (!flushStarted.load(std::memory_order_relaxed)) {
+        bool expected = false;
+        if (flushStarted.compare_exchange_strong(expected, true))
+            new pros::Task {[=] { flushMessages(); }, TASK_PRIORITY_MIN, TASK_STACK_DEPTH_DEFAULT, "logger"};
+    }
+    if (!logBuffer.push(record)) droppedMessages.fetch_add(1, std::memory_order_relaxed);
 }
 
-bool checkLowestLevel(lemlib::logger::Level level) { return ordinal(level) >= ordinal(lemlib::logger::lowestLevel); }
+/**
+ * @brief Queue a message to be printed by the flush task
+ *
+ * @param level the level of the message
+ * @param message the message
+ * @param exception the exception, or nullptr if there is none
+ */
+static void enqueue(lemlib::logger::Level level, const char* message, const char* exception) {
+    LogRecord_t record;
+    record.level = level;
+    std::size_t length = append(record, 0, message);
+    if (exception != nullptr) {
+        length = append(record, length, ": ");
+        append(record, length, exception);
+    }
+    push(record);
+}
 
 /*
 End of util functions
 */
 
+/**
+ * @brief Whether a message of a level would be logged with the current configuration
+ *
+ * @param level the level of the message
+ * @return true if the message would be logged
+ */
+bool lemlib::logger::isEnabled(Level level) {
+    if (ordinal(level) < LEMLIB_LOG_LEVEL) return false;
+    if (ordinal(level) < ordinal(getLowestLevel())) return false;
+    if (level == Level::DEBUG && !isDebug()) return false;
+    if (level == Level::INFO && !isVerbose()) return false;
+    return true;
+}
+
+/**
+ * @brief Get the number of messages dropped because the log buffer was full
+ *
+ * @return int
+ */
+int lemlib::logger::getDroppedMessages() { return droppedMessages.load(); }
+
 /**
  * @brief Logs a message with an exception
  *
@@ -106,16 +241,12 @@ End of util functions
  * @param exception the exception
  */
 void lemlib::logger::log(Level level, const char* message, const char* exception) {
-    if (!checkLowestLevel(level)) return;
-    if (level == Level::DEBUG && !lemlib::debug) return;
-    if (level == Level::INFO && !lemlib::verbose) return;
+    if (!isEnabled(level)) return;
 
     if (message == nullptr) message = "";
     if (exception == nullptr) throw std::invalid_argument("exception cannot be null");
 
-    std::string messageString = "[LemLib] " + getFormattedLevel(level) + ": " + message + ": " + exception + RESET_ANSI;
-
-    std::cout << messageString << std::endl;
+    enqueue(level, message, exception);
 }
 
 /**
@@ -125,15 +256,29 @@ void lemlib::logger::log(Level level, const char* message, const char* exception
  * @param message the message
  */
 void lemlib::logger::log(Level level, const char* message) {
-    if (!checkLowestLevel(level)) return;
-    if (level == Level::DEBUG && !lemlib::debug) return;
-    if (level == Level::INFO && !lemlib::verbose) return;
+    if (!isEnabled(level)) return;
 
     if (message == nullptr) message = "";
 
-    std::string messageString = "[LemLib] " + getFormattedLevel(level) + ": " + message + RESET_ANSI;
+    enqueue(level, message, nullptr);
+}
 
-    std::cout << messageString << std::endl;
+/**
+ * @brief Logs a message formatted like printf
+ *
+ * @param level the level of the message
+ * @param format the printf format of the message
+ */
+void lemlib::logger::logf(Level level, const char* format, ...) {
+    if (!isEnabled(level)) return;
+
+    LogRecord_t record;
+    record.level = level;
+    std::va_list args;
+    va_start(args, format);
+    std::vsnprintf(record.text, sizeof(record.text), format, args);
+    va_end(args);
+    push(record);
 }
 
 /**
@@ -0,0 +1,87 @@
+/**
+ * @file src/lemlib/motionProfile.cpp
+ * @author LemLib Team
+ * @brief Motion profile definitions
+ * @version 0.4.5
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#include <algorithm>
+#include <math.h>
+#include "lemlib/motionProfile.hpp"
+
+/**
+ * @brief Construct a new Motion Profile
+ *
+ * @param distance the distance to travel. Can be negative
+ * @param constraints the velocity and acceleration limits
+ * @param shape the shape of the profile
+ */
+lemlib::MotionProfile::MotionProfile(float distance, ProfileConstraints_t constraints, ProfileShape shape)
+    : shape(shape) {
+    sign = (distance < 0) ? -1 : 1;
+    this->distance = std::fabs(distance);
+    if (this->distance == 0 || constraints.maxVelocity <= 0 || constraints.maxAcceleration <= 0) return;
+    // time to reach a velocity is velocity * k, and the distance covered meanwhile is half of velocity * time
+    float k = (shape == ProfileShape::S_CURVE) ? M_PI / (2 * constraints.maxAcceleration)
+                                               : 1 / constraints.maxAcceleration;
+    // accelerating and decelerating to the peak velocity covers velocity^2 * k
+    peakVelocity = std::min(constraints.maxVelocity, std::sqrt(this->distance / k));
+    accelTime = peakVelocity * k;
+    cruiseTime = std::max((this->distance - peakVelocity * accelTime) / peakVelocity, 0.0f);
+    duration = 2 * accelTime + cruiseTime;
+}
+
+/**
+ * @brief Get the state of the acceleration phase
+ *
+ * @param t time since the start of the acceleration phase in seconds
+ * @return ProfileState_t
+ */
+lemlib::ProfileState_t lemlib::MotionProfile::ramp(float t) {
+    float u = t / accelTime;
+    if (shape == ProfileShape::S_CURVE) {
+        float angle = M_PI * u;
+        float pi = M_PI;
+        return {peakVelocity * accelTime / 2 * (u - std::sin(angle) / pi), peakVelocity * (1 - std::cos(angle)) / 2,
+                peakVelocity * pi / (2 * accelTime) * std::sin(angle)};
+    } else {
+        return {peakVelocity * accelTime * u * u / 2, peakVelocity * u, peakVelocity / accelTime};
+    }
+}
+
+/**
+ * @brief Get the state of the profile at a point in time
+ *
+ * @param t time since the start of the profile in seconds. Times past the end give the final state
+ * @return ProfileState_t
+ */
+lemlib::ProfileState_t lemlib::MotionProfile::sample(float t) {
+    ProfileState_t state = {0, 0, 0};
+    if (duration <= 0 || t >= duration) {
+        state.position = distance;
+    } else if (t <= 0) {
+        state.position = 0;
+    } else if (t < accelTime) { // accelerating
+        state = ramp(t);
+    } else if (t < accelTime + cruiseTime) { // cruising
+        state.position = peakVelocity * accelTime / 2 + peakVelocity * (t - accelTime);
+        state.velocity = peakVelocity;
+    } else { // decelerating, which mirrors accelerating
+        ProfileState_t mirrored = ramp(duration - t);
+        state.position = distance - mirrored.position;
+        state.velocity = mirrored.velocity;
+        state.acceleration = -mirrored.acceleration;
+    }
+    return {state.position * sign, state.velocity * sign, state.acceleration * sign};
+}
+
+/**
+ * @brief Get how long the profile takes
+ *
+ * @return float duration in seconds
+ */
+float lemlib::MotionProfile::getDuration() { return duration; }
@@ -9,15 +9,34 @@
  *
  */
 
+#include <algorithm>
+#include <cstdlib>
 #include <iostream>
+#include <vector>
 #include <math.h>
 #include "lemlib/pid.hpp"
 #include "lemlib/util.hpp"
 
 // define static variables
-std::string lemlib::FAPID::input = "FAPID";
 pros::Task* lemlib::FAPID::logTask = nullptr;
-pros::Mutex lemlib::FAPID::logMutex = pros::Mutex();
+
+/**
+ * @brief Every FAPID that exists, so the terminal task can find them by name
+ *
+ * Created on first use, since FAPIDs may be constructed before this file's globals are
+ */
+static std::vector<lemlib::FAPID*>& fapidRegistry() {
+    static std::vector<lemlib::FAPID*> registry;
+    return registry;
+}
+
+/**
+ * @brief Mutex guarding the registry. Only taken when a FAPID is created or destroyed, and by the terminal task
+ */
+static pros::Mutex& fapidRegistryMutex() {
+    static pros::Mutex mutex;
+    return mutex;
+}
 
 /**
  * @brief Construct a new FAPID
@@ -36,6 +55,74 @@ lemlib::FAPID::FAPID(float kF, float kA, float kP, float kI, float kD, std::stri
     this->kI = kI;
     this->kD = kD;
     this->name = name;
+    this->mirror();
+    fapidRegistryMutex().take(TIMEOUT_MAX);
+    fapidRegistry().push_back(this);
+    fapidRegistryMutex().give();
+}
+
+/**
+ * @brief Copy a FAPID. The copy can be tuned separately, under the same name
+ *
+ * @param other the FAPID to copy
+ */
+lemlib::FAPID::FAPID(const FAPID& other) {
+    *this = other;
+    fapidRegistryMutex().take(TIMEOUT_MAX);
+    fapidRegistry().push_back(this);
+    fapidRegistryMutex().give();
+}
+
+/**
+ * @brief Copy the gains and state of another FAPID
+ *
+ * Commands queued for the other FAPID are not copied
+ *
+ * @param other the FAPID to copy
+ * @return FAPID&
+ */
+lemlib::FAPID& lemlib::FAPID::operator=(const FAPID& other) {
+    kF = other.kF;
+    kA = other.kA;
+    kP = other.kP;
+    kI = other.kI;
+    kD = other.kD;
+    largeError = other.largeError;
+    smallError = other.smallError;
+    largeTime = other.largeTime;
+    settleError = other.settleError;
+    settleSpeed = other.settleSpeed;
+    smallTime = other.smallTime;
+    maxTime = other.maxTime;
+    largeTimeCounter = other.largeTimeCounter;
+    smallTimeCounter = other.smallTimeCounter;
+    startTime = other.startTime;
+    clock = other.clock;
+    schedule = other.schedule;
+    maxIntegral = other.maxIntegral;
+    integralSignReset = other.integralSignReset;
+    derivativeTimeConstant = other.derivativeTimeConstant;
+    derivativeOnMeasurement = other.derivativeOnMeasurement;
+    prevDeltaError = other.prevDeltaError;
+    prevPosition = other.prevPosition;
+    hasPrevPosition = other.hasPrevPosition;
+    prevError = other.prevError;
+    totalError = other.totalError;
+    prevOutput = other.prevOutput;
+    name = other.name;
+    mirror();
+    return *this;
+}
+
+/**
+ * @brief Destroy the FAPID
+ *
+ */
+lemlib::FAPID::~FAPID() {
+    fapidRegistryMutex().take(TIMEOUT_MAX);
+    std::vector<FAPID*>& registry = fapidRegistry();
+    registry.erase(std::remove(registry.begin(), registry.end(), this), registry.end());
+    fapidRegistryMutex().give();
 }
 
 /**
@@ -53,6 +140,36 @@ void lemlib::FAPID::setGains(float kF, float kA, float kP, float kI, float kD) {
     this->kP = kP;
     this->kI = kI;
     this->kD = kD;
+    this->mirror();
+}
+
+/**
+ * @brief Set a gain schedule, which scales kP and kD every update
+ *
+ * @param schedule the schedule to use, or nullptr for none. Must stay alive while it is set
+ */
+void lemlib::FAPID::setSchedule(const GainSchedule* schedule) { this->schedule = schedule; }
+
+/**
+ * @brief Set the integral anti-windup
+ *
+ * @param maxIntegral largest output the integral term can contribute. 0 for no limit
+ * @param resetOnSignChange whether to reset the integral when the error crosses 0
+ */
+void lemlib::FAPID::setIntegral(float maxIntegral, bool resetOnSignChange) {
+    this->maxIntegral = maxIntegral;
+    this->integralSignReset = resetOnSignChange;
+}
+
+/**
+ * @brief Set the derivative low-pass filter and what the derivative is taken of
+ *
+ * @param timeConstantMs time constant of the low-pass filter in milliseconds. 0 for no filtering
+ * @param onMeasurement true to take the derivative of the position instead of the error
+ */
+void lemlib::FAPID::setDerivative(float timeConstantMs, bool onMeasurement) {
+    this->derivativeTimeConstant = timeConstantMs;
+    this->derivativeOnMeasurement = onMeasurement;
 }
 
 /**
@@ -72,6 +189,17 @@ void lemlib::FAPID::setExit(float largeError, float smallError, int largeTime, i
     this->maxTime = maxTime;
 }
 
+/**
+ * @brief Set a velocity based exit condition
+ *
+ * @param maxError largest error the FAPID can settle at
+ * @param maxSpeed largest change in error per second the FAPID can settle at. 0 to disable
+ */
+void lemlib::FAPID::setVelocityExit(float maxError, float maxSpeed) {
+    this->settleError = maxError;
+    this->settleSpeed = maxSpeed;
+}
+
 /**
  * @brief Update the FAPID
  *
@@ -81,18 +209,57 @@ void lemlib::FAPID::setExit(float largeError, float smallError, int largeTime, i
  * PIDs could slow down the program.
  * @return float - output
  */
-float lemlib::FAPID::update(float target, float position, bool log) {
-    // check most recent input if logging is enabled
-    // this does not run by default because the mutexes could slow down the program
+float lemlib::FAPID::update(float target, float position, bool log) { return updateDt(target, position, 10, log); }
+
+/**
+ * @brief Update the FAPID with the time since the last update
+ *
+ * @param target the target value
+ * @param position the current value
+ * @param dtMs time since the last update in milliseconds
+ * @param log whether to check the most recent terminal input for user input. Default is false because logging multiple
+ * PIDs could slow down the program.
+ * @return float - output
+ */
+float lemlib::FAPID::updateDt(float target, float position, float dtMs, bool log) {
+    // apply gain changes from the terminal if logging is enabled. This never blocks
     if (log) { lemlib::FAPID::log(); }
+    // the gains are tuned for a 10ms loop
+    float ticks = dtMs / 10;
     // calculate output
     float error = target - position;
-    float deltaError = error - prevError;
-    float output = kF * target + kP * error + kI * totalError + kD * deltaError;
-    if (kA != 0) output = lemlib::slew(output, prevOutput, kA);
+    float deltaError = 0;
+    if (ticks > 0) {
+        // on measurement, the derivative doesn't spike when the target changes
+        if (derivativeOnMeasurement) deltaError = (hasPrevPosition) ? -(position - prevPosition) / ticks : 0;
+        else deltaError = (error - prevError) / ticks;
+        // low-pass filter the derivative
+        if (derivativeTimeConstant > 0) {
+            deltaError = prevDeltaError + (deltaError - prevDeltaError) * dtMs / (derivativeTimeConstant + dtMs);
+        }
+    }
+    // scale the gains by the schedule
+    float pScale = 1, dScale = 1;
+    if (schedule != nullptr) {
+        float key = (schedule->getKey() == ScheduleKey::ERROR) ? error : deltaError * 100; // change per second
+        schedule->lookup(key, pScale, dScale);
+    }
+    float output = kF * target + kP * pScale * error + kI * totalError + kD * dScale * deltaError;
+    if (kA != 0) output = lemlib::slew(output, prevOutput, kA * ticks);
     prevOutput = output;
+    // reset the integral once the error crosses 0, so it doesn't push past the target
+    if (integralSignReset && sgn(error) != sgn(prevError)) totalError = 0;
     prevError = error;
-    totalError += error;
+    prevDeltaError = deltaError;
+    prevPosition = position;
+    hasPrevPosition = true;
+    totalError += error * ticks;
+    // clamp the integral so the integral term can't exceed maxIntegral
+    if (maxIntegral > 0 && kI != 0) {
+        float limit = maxIntegral / std::fabs(kI);
+        totalError = std::clamp(totalError, -limit, limit);
+    }
+    mirrored[5].store(totalError, std::memory_order_relaxed);
     return output;
 }
 
@@ -103,6 +270,10 @@ void lemlib::FAPID::reset() {
     prevError = 0;
     totalError = 0;
     prevOutput = 0;
+    prevDeltaError = 0;
+    prevPosition = 0;
+    hasPrevPosition = false;
+    mirror();
 }
 
 /**
@@ -114,24 +285,36 @@ void lemlib::FAPID::reset() {
  * @return false - the FAPID has not settled
  */
 bool lemlib::FAPID::settled() {
-    if (startTime == 0) { // if maxTime has not been set
-        startTime = pros::c::millis();
+    int now = clock->millis();
+    if (startTime == -1) { // if maxTime has not been set
+        startTime = now;
         return false;
     } else { // check if the FAPID has settled
-        if (pros::c::millis() - startTime > maxTime) return true; // maxTime has been exceeded
+        if (maxTime != -1 && now - startTime > maxTime) return true; // maxTime has been exceeded
+        // stopped within tolerance. prevDeltaError is the change in error per 10ms
+        if (settleSpeed > 0 && hasPrevPosition && std::fabs(prevError) < settleError &&
+            std::fabs(prevDeltaError) * 100 < settleSpeed)
+            return true;
         if (std::fabs(prevError) < largeError) { // largeError within range
-            if (!largeTimeCounter) largeTimeCounter = pros::c::millis(); // largeTimeCounter has not been set
-            else if (pros::c::millis() - largeTimeCounter > largeTime) return true; // largeTime has been exceeded
+            if (largeTimeCounter == -1) largeTimeCounter = now; // largeTimeCounter has not been set
+            else if (now - largeTimeCounter > largeTime) return true; // largeTime has been exceeded
         }
         if (std::fabs(prevError) < smallError) { // smallError within range
-            if (!smallTimeCounter) smallTimeCounter = pros::c::millis(); // smallTimeCounter has not been set
-            else if (pros::c::millis() - smallTimeCounter > smallTime) return true; // smallTime has been exceeded
+            if (smallTimeCounter == -1) smallTimeCounter = now; // smallTimeCounter has not been set
+            else if (now - smallTimeCounter > smallTime) return true; // smallTime has been exceeded
         }
         // if none of the exit conditions have been met
         return false;
     }
 }
 
+/**
+ * @brief Set the clock used by settled()
+ *
+ * @param clock the clock to use. Must stay alive while the FAPID is used
+ */
+void lemlib::FAPID::setClock(Clock& clock) { this->clock = &clock; }
+
 /**
  * @brief Enable logging
  * the user can interact with the FAPID through the terminal
@@ -148,62 +331,100 @@ bool lemlib::FAPID::settled() {
  * reset()
  */
 void lemlib::FAPID::init() {
-    if (logTask != nullptr) {
-        logTask = new pros::Task {[=] {
-            while (true) {
-                // get input
-                std::cin >> input;
-                pros::delay(20);
+    if (logTask == nullptr) {
+        logTask = new pros::Task {[=] { readCommands(); }};
+    }
+}
+
+/**
+ * @brief Read commands from the terminal and pass them to the FAPIDs they name
+ *
+ * Runs in its own task. Values are read from the mirrored copies, and gain changes are queued, so the FAPIDs are
+ * never touched directly
+ */
+void lemlib::FAPID::readCommands() {
+    const char* variables[] = {"kF", "kA", "kP", "kI", "kD", "totalError"};
+    std::string input;
+    while (true) {
+        // get input
+        std::cin >> input;
+        pros::delay(20);
+        // split the input into <name>.<variable>
+        std::size_t dot = input.find('.');
+        if (dot == std::string::npos) continue;
+        std::string name = input.substr(0, dot);
+        std::string variable = input.substr(dot + 1);
+
+        // parse the command
+        int get = -1; // index of the variable to get, -1 if this command sets a value
+        TuningCommand_t command = {Command::RESET, 0};
+        if (variable == "reset()") {
+            command.command = Command::RESET;
+        } else {
+            bool valid = false;
+            for (int i = 0; i < 6; i++) {
+                std::string prefix = std::string(variables[i]) + "_";
+                if (variable == variables[i]) {
+                    get = i;
+                    valid = true;
+                } else if (i < 5 && variable.find(prefix) == 0) {
+                    const char* value = variable.c_str() + prefix.length();
+                    char* end = nullptr;
+                    command.value = std::strtof(value, &end);
+                    command.command = Command(i);
+                    valid = end != value;
+                }
             }
-        }};
+            if (!valid) continue;
+        }
+
+        // pass the command to every FAPID with a matching name
+        float value = 0;
+        bool found = false;
+        fapidRegistryMutex().take(TIMEOUT_MAX);
+        for (FAPID* pid : fapidRegistry()) {
+            if (pid->name != name) continue;
+            if (get != -1 && !found) value = pid->mirrored[get].load(std::memory_order_relaxed);
+            else if (get == -1) pid->commands.push(command);
+            found = true;
+        }
+        fapidRegistryMutex().give();
+        // print outside of the lock, so FAPIDs aren't kept waiting on the terminal
+        if (get != -1 && found) std::cout << value << std::endl;
     }
 }
 
 /**
- * @brief Log the FAPID
+ * @brief Apply the gain changes queued by the terminal task
+ *
+ * Only ever pops from the queue, so it never blocks
  */
 void lemlib::FAPID::log() {
-    // check if the input starts with the name of the FAPID
-    // try to obtain the logging mutex
-    if (logMutex.take(5)) {
-        if (input.find(name) == 0) {
-            // remove the name from the input
-            input.erase(0, name.length() + 1);
-            // check if the input is a function
-            if (input == "reset()") {
-                reset();
-            } else if (input == "kF") {
-                std::cout << kF << std::endl;
-            } else if (input == "kA") {
-                std::cout << kA << std::endl;
-            } else if (input == "kP") {
-                std::cout << kP << std::endl;
-            } else if (input == "kI") {
-                std::cout << kI << std::endl;
-            } else if (input == "kD") {
-                std::cout << kD << std::endl;
-            } else if (input == "totalError") {
-                std::cout << totalError << std::endl;
-            } else if (input.find("kF_") == 0) {
-                input.erase(0, 3);
-                kF = std::stof(input);
-            } else if (input.find("kA_") == 0) {
-                input.erase(0, 3);
-                kA = std::stof(input);
-            } else if (input.find("kP_") == 0) {
-                input.erase(0, 3);
-                kP = std::stof(input);
-            } else if (input.find("kI_") == 0) {
-                input.erase(0, 3);
-                kI = std::stof(input);
-            } else if (input.find("kD_") == 0) {
-                input.erase(0, 3);
-                kD = std::stof(input);
-            }
-            // clear the input
-            input = "";
+    TuningCommand_t command;
+    bool changed = false;
+    while (commands.pop(command)) {
+        switch (command.command) {
+            case Command::SET_KF: kF = command.value; break;
+            case Command::SET_KA: kA = command.value; break;
+            case Command::SET_KP: kP = command.value; break;
+            case Command::SET_KI: kI = command.value; break;
+            case Command::SET_KD: kD = command.value; break;
+            case Command::RESET: reset(); break;
         }
-        // release the logging mutex
-        logMutex.give();
+        changed = true;
     }
+    if (changed) mirror();
+}
+
+/**
+ * @brief Copy the gains and total error to the mirrored values read by the terminal task
+ *
+ */
+void lemlib::FAPID::mirror() {
+    mirrored[0].store(kF, std::memory_order_relaxed);
+    mirrored[1].store(kA, std::memory_order_relaxed);
+    mirrored[2].store(kP, std::memory_order_relaxed);
+    mirrored[3].store(kI, std::memory_order_relaxed);
+    mirrored[4].store(kD, std::memory_order_relaxed);
+    mirrored[5].store(totalError, std::memory_order_relaxed);
 }
@@ -0,0 +1,195 @@
+/**
+ * @file src/lemlib/pidBank.cpp
+ * @author LemLib Team
+ * @brief PIDBank class definitions
+ * @version 0.4.5
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#include <math.h>
+#include "lemlib/pidBank.hpp"
+#ifdef __ARM_NEON
+#include <arm_neon.h>
+#endif
+
+static_assert(lemlib::PIDBank::CAPACITY % 4 == 0, "PIDBank capacity must be a multiple of 4");
+
+/**
+ * @brief Add a controller
+ *
+ * @param name name of the controller, used to find it later
+ * @param kF feedfoward gain, multiplied by target and added to output. Set 0 if disabled
+ * @param kA acceleration gain, limits the change in output per 10ms. Set 0 if disabled
+ * @param kP proportional gain, multiplied by error and added to output
+ * @param kI integral gain, multiplied by total error and added to output
+ * @param kD derivative gain, multiplied by change in error and added to output
+ * @return int id of the controller, or -1 if the bank is full
+ */
+int lemlib::PIDBank::add(const std::string& name, float kF, float kA, float kP, float kI, float kD) {
+    if (count >= CAPACITY) return -1;
+    int id = count++;
+    names[id] = name;
+    setGains(id, kF, kA, kP, kI, kD);
+    reset(id);
+    return id;
+}
+
+/**
+ * @brief Find a controller by name
+ *
+ * @param name name of the controller
+ * @return int id of the controller, or -1 if there is none with that name
+ */
+int lemlib::PIDBank::find(const std::string& name) const {
+    for (int i = 0; i < count; i++) {
+        if (names[i] == name) return i;
+    }
+    return -1;
+}
+
+/**
+ * @brief Set the gains of a controller
+ *
+ * @param id id of the controller
+ * @param kF feedfoward gain
+ * @param kA acceleration gain. Set 0 if disabled
+ * @param kP proportional gain
+ * @param kI integral gain
+ * @param kD derivative gain
+ */
+void lemlib::PIDBank::setGains(int id, float kF, float kA, float kP, float kI, float kD) {
+    if (!valid(id)) return;
+    this->kF[id] = kF;
+    this->kP[id] = kP;
+    this->kI[id] = kI;
+    this->kD[id] = kD;
+    slewLimit[id] = (kA == 0) ? INFINITY : std::fabs(kA);
+    updateLimits(id);
+}
+
+/**
+ * @brief Limit the output the integral term of a controller can contribute
+ *
+ * @param id id of the controller
+ * @param maxIntegral largest output of the integral term. 0 for no limit
+ */
+void lemlib::PIDBank::setIntegralLimit(int id, float maxIntegral) {
+    if (!valid(id)) return;
+    maxIntegrals[id] = maxIntegral;
+    updateLimits(id);
+}
+
+/**
+ * @brief Set the target of a controller
+ *
+ * @param id id of the controller
+ * @param target the target value
+ */
+void lemlib::PIDBank::setTarget(int id, float target) {
+    if (valid(id)) this->target[id] = target;
+}
+
+/**
+ * @brief Set the current value of a controller
+ *
+ * @param id id of the controller
+ * @param position the current value
+ */
+void lemlib::PIDBank::setPosition(int id, float position) {
+    if (valid(id)) this->position[id] = position;
+}
+
+/**
+ * @brief Update every controller
+ *
+ * @param dtMs time since the last update in milliseconds
+ */
+void lemlib::PIDBank::update(float dtMs) {
+    if (dtMs <= 0) return;
+    float ticks = dtMs / 10;
+    float invTicks = 1 / ticks;
+    // round up to a whole number of groups of 4. The extra slots are 0, so they stay 0
+    int lanes = (count + 3) & ~3;
+#ifdef __ARM_NEON
+    for (int i = 0; i < lanes; i += 4) {
+        float32x4_t t = vld1q_f32(&target[i]);
+        float32x4_t error = vsubq_f32(t, vld1q_f32(&position[i]));
+        float32x4_t deltaError = vmulq_n_f32(vsubq_f32(error, vld1q_f32(&prevError[i])), invTicks);
+        float32x4_t total = vld1q_f32(&totalError[i]);
+        float32x4_t out = vmulq_f32(vld1q_f32(&kF[i]), t);
+        out = vmlaq_f32(out, vld1q_f32(&kP[i]), error);
+        out = vmlaq_f32(out, vld1q_f32(&kI[i]), total);
+        out = vmlaq_f32(out, vld1q_f32(&kD[i]), deltaError);
+        // limit the change in output
+        float32x4_t prev = vld1q_f32(&output[i]);
+        float32x4_t limit = vmulq_n_f32(vld1q_f32(&slewLimit[i]), ticks);
+        float32x4_t change = vminq_f32(vmaxq_f32(vsubq_f32(out, prev), vnegq_f32(limit)), limit);
+        vst1q_f32(&output[i], vaddq_f32(prev, change));
+        // accumulate and clamp the integral
+        float32x4_t integralMax = vld1q_f32(&integralLimit[i]);
+        total = vmlaq_n_f32(total, error, ticks);
+        vst1q_f32(&totalError[i], vminq_f32(vmaxq_f32(total, vnegq_f32(integralMax)), integralMax));
+        vst1q_f32(&prevError[i], error);
+    }
+#else
+    // same math one controller at a time, written so the compiler can vectorize it
+    for (int i = 0; i < lanes; i++) {
+        float error = target[i] - position[i];
+        float deltaError = (error - prevError[i]) * invTicks;
+        float out = kF[i] * target[i] + kP[i] * error + kI[i] * totalError[i] + kD[i] * deltaError;
+        float limit = slewLimit[i] * ticks;
+        output[i] += std::fmin(std::fmax(out - output[i], -limit), limit);
+        float total = totalError[i] + error * ticks;
+        totalError[i] = std::fmin(std::fmax(total, -integralLimit[i]), integralLimit[i]);
+        prevError[i] = error;
+    }
+#endif
+}
+
+/**
+ * @brief Get the output of a controller from the last update
+ *
+ * @param id id of the controller
+ * @return float output
+ */
+float lemlib::PIDBank::getOutput(int id) const { return valid(id) ? output[id] : 0; }
+
+/**
+ * @brief Reset the state of a controller
+ *
+ * @param id id of the controller
+ */
+void lemlib::PIDBank::reset(int id) {
+    if (!valid(id)) return;
+    prevError[id] = 0;
+    totalError[id] = 0;
+    output[id] = 0;
+}
+
+/**
+ * @brief Get the number of controllers
+ *
+ * @return int
+ */
+int lemlib::PIDBank::size() const { return count; }
+
+/**
+ * @brief Whether an id refers to a controller
+ *
+ * @param id id of the controller
+ * @return true if the id is valid
+ */
+bool lemlib::PIDBank::valid(int id) const { return id >= 0 && id < count; }
+
+/**
+ * @brief Convert the integral limit of a controller from output to total error
+ *
+ * @param id id of the controller
+ */
+void lemlib::PIDBank::updateLimits(int id) {
+    if (maxIntegrals[id] > 0 && kI[id] != 0) integralLimit[id] = maxIntegrals[id] / std::fabs(kI[id]);
+    else integralLimit[id] = INFINITY;
+}
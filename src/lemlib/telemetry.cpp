@@ -0,0 +1,301 @@
+/**
+ * @file src/lemlib/telemetry.cpp
+ * @author LemLib Team
+ * @brief Binary telemetry stream definitions
+ * @version 0.4.5
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include "pros/rtos.hpp"
+#include "pros/apix.h"
+#include "lemlib/ringBuffer.hpp"
+#include "lemlib/telemetry.hpp"
+
+/**
+ * @brief A value waiting to be sent
+ *
+ */
+typedef struct {
+        std::uint32_t time;
+        std::uint8_t channel;
+        std::uint8_t bytes[4];
+} Sample_t;
+
+/**
+ * @brief A registered channel
+ *
+ */
+typedef struct {
+        lemlib::telemetry::ChannelType type;
+        char name[lemlib::telemetry::MAX_NAME_LENGTH + 1];
+} Channel_t;
+
+// sender thread
+static pros::Task* senderTask = nullptr;
+
+// samples waiting to be sent. 256 samples is 10 channels for a quarter of a second at 100 Hz
+static lemlib::MPSCRingBuffer<Sample_t, 256> sampleBuffer;
+// whether telemetry should be sent, and whether the sender is sending it. The sender switches the serial driver
+// between the two modes, so it never changes in the middle of a frame
+static std::atomic<bool> sending(false);
+static std::atomic<bool> streaming(false);
+static std::atomic<int> droppedSamples(0);
+
+static Channel_t channels[lemlib::telemetry::MAX_CHANNELS];
+static std::atomic<int> channelCount(0);
+// number of channels the sender has announced
+static int announcedChannels = 0;
+static pros::Mutex channelMutex;
+
+// the most samples in one frame, so an encoded frame always fits in 255 bytes
+constexpr int MAX_FRAME_SAMPLES = 40;
+
+/**
+ * @brief Calculate the CRC-16/CCITT-FALSE of some bytes
+ *
+ * @param data the bytes
+ * @param length the number of bytes
+ * @return std::uint16_t
+ */
+static std::uint16_t crc16(const std::uint8_t* data, std::size_t length) {
+    std::uint16_t crc = 0xFFFF;
+    for (std::size_t i = 0; i < length; i++) {
+        crc ^= std::uint16_t(data[i]) << 8;
+        for (int bit = 0; bit < 8; bit++) crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : crc << 1;
+    }
+    return crc;
+}
+
+/**
+ * @brief Encode bytes with Consistent Overhead Byte Stuffing, so the output has no 0 bytes
+ *
+ * @param input the bytes to encode
+ * @param length the number of bytes to encode
+ * @param output where to store the encoded bytes. Must have room for length + length / 254 + 1 bytes
+ * @return std::size_t the number of encoded bytes
+ */
+static std::size_t cobsEncode(const std::uint8_t* input, std::size_t length, std::uint8_t* output) {
+    std::size_t write = 1;
+    std::size_t codeIndex = 0;
+    std::uint8_t code = 1;
+    for (std::size_t read = 0; read < length; read++) {
+        if (input[read] == 0) {
+            output[codeIndex] = code;
+            code = 1;
+            codeIndex = write++;
+        } else {
+            output[write++] = input[read];
+            code++;
+            // a block can hold at most 254 bytes
+            if (code == 0xFF) {
+                output[codeIndex] = code;
+                code = 1;
+                codeIndex = write++;
+            }
+        }
+    }
+    output[codeIndex] = code;
+    return write;
+}
+
+/**
+ * @brief Add a CRC to a frame, encode it and write it to the serial port
+ *
+ * @param frame the frame. Must have room for 2 more bytes
+ * @param length the length of the frame
+ */
+static void sendFrame(std::uint8_t* frame, std::size_t length) {
+    std::uint16_t crc = crc16(frame, length);
+    frame[length++] = crc & 0xFF;
+    frame[length++] = crc >> 8;
+    std::uint8_t encoded[300];
+    encoded[0] = 0;
+    std::size_t size = cobsEncode(frame, length, encoded + 1) + 1;
+    encoded[size++] = 0;
+    std::fwrite(encoded, 1, size, stdout);
+}
+
+/**
+ * @brief Send a channel frame
+ *
+ * @param id the id of the channel
+ */
+static void sendChannel(int id) {
+    std::uint8_t frame[3 + lemlib::telemetry::MAX_NAME_LENGTH + 2];
+    frame[0] = std::uint8_t(lemlib::telemetry::FrameKind::CHANNEL);
+    frame[1] = id;
+    frame[2] = std::uint8_t(channels[id].type);
+    std::size_t nameLength = std::strlen(channels[id].name);
+    std::memcpy(frame + 3, channels[id].name, nameLength);
+    sendFrame(frame, 3 + nameLength);
+}
+
+/**
+ * @brief Send queued samples in frames, and announce the channels. Runs in its own low priority task
+ *
+ * Nothing is written while telemetry is stopped, and the serial driver is left in its normal mode
+ */
+static void sendSamples() {
+    std::uint32_t lastAnnounce = 0;
+    bool pending = false;
+    Sample_t sample;
+    while (true) {
+        // switch the serial driver between frames
+        if (sending.load() != streaming.load()) {
+            if (sending.load()) {
+                pros::c::serctl(SERCTL_DISABLE_COBS, nullptr);
+                // announce every channel straight away, so the decoder can start
+                lastAnnounce = pros::millis() - 1000;
+                streaming.store(true);
+            } else {
+                // drop the samples that haven't been sent, so they aren't sent with old times after a restart
+                pending = false;
+                while (sampleBuffer.pop(sample)) {}
+                std::fflush(stdout);
+                pros::c::serctl(SERCTL_ENABLE_COBS, nullptr);
+                streaming.store(false);
+            }
+        }
+        if (!streaming.load()) {
+            pros::delay(10);
+            continue;
+        }
+
+        // announce new channels straight away, and every channel once a second
+        int count = channelCount.load();
+        bool announceAll = pros::millis() - lastAnnounce >= 1000;
+        for (int i = announceAll ? 0 : announcedChannels; i < count; i++) sendChannel(i);
+        announcedChannels = count;
+        if (announceAll) lastAnnounce = pros::millis();
+
+        // pack samples into frames. A frame ends when it is full or a sample is too far from its first sample
+        int sent = 0;
+        while (pending || sampleBuffer.pop(sample)) {
+            pending = false;
+            std::uint8_t frame[6 + MAX_FRAME_SAMPLES * 6 + 2];
+            frame[0] = std::uint8_t(lemlib::telemetry::FrameKind::SAMPLES);
+            std::memcpy(frame + 1, &sample.time, 4);
+            std::uint32_t start = sample.time;
+            int samples = 0;
+            do {
+                if (sample.time - start > 255) {
+                    pending = true;
+                    break;
+                }
+                std::uint8_t* entry = frame + 6 + samples * 6;
+                entry[0] = sample.channel;
+                entry[1] = sample.time - start;
+                std::memcpy(entry + 2, sample.bytes, 4);
+                samples++;
+            } while (samples < MAX_FRAME_SAMPLES && sampleBuffer.pop(sample));
+            frame[5] = samples;
+            sendFrame(frame, 6 + samples * 6);
+            sent++;
+        }
+        if (sent > 0 || announceAll) std::fflush(stdout);
+        pros::delay(10);
+    }
+}
+
+/**
+ * @brief Add a channel
+ *
+ * @param name the name of the channel. Truncated to MAX_NAME_LENGTH characters
+ * @param type the type of the values. FLOAT by default
+ * @return int the id of the channel, or -1 if there are already MAX_CHANNELS channels
+ */
+int lemlib::telemetry::addChannel(const char* name, ChannelType type) {
+    channelMutex.take(TIMEOUT_MAX);
+    int id = channelCount.load();
+    if (id < MAX_CHANNELS) {
+        channels[id].type = type;
+        std::strncpy(channels[id].name, name, MAX_NAME_LENGTH);
+        channels[id].name[MAX_NAME_LENGTH] = '\0';
+        // publish the channel only once it is filled in
+        channelCount.store(id + 1);
+    } else {
+        id = -1;
+    }
+    channelMutex.give();
+    return id;
+}
+
+/**
+ * @brief Start sending telemetry over the serial port
+ *
+ */
+void lemlib::telemetry::start() {
+    sending.store(true);
+    if (senderTask == nullptr)
+        senderTask = new pros::Task {[=] { sendSamples(); }, TASK_PRIORITY_MIN, TASK_STACK_DEPTH_DEFAULT, "telemetry"};
+}
+
+/**
+ * @brief Stop sending telemetry, and restore the stream multiplexing of the PROS serial driver
+ *
+ */
+void lemlib::telemetry::stop() {
+    sending.store(false);
+    // wait for the sender to finish its frame and restore the serial driver
+    while (streaming.load()) pros::delay(1);
+}
+
+/**
+ * @brief Queue the bytes of a value to be sent
+ *
+ * @param channel the id of the channel
+ * @param type the type of the value, which must be the type of the channel
+ * @param value pointer to the 4 bytes of the value
+ * @return true if the value was queued
+ */
+static bool queueSample(int channel, lemlib::telemetry::ChannelType type, const void* value) {
+    if (!sending.load(std::memory_order_relaxed)) return false;
+    // a channel is filled in before it is counted, so only read channels that are counted
+    if (channel < 0 || channel >= channelCount.load()) return false;
+    // the decoder reads the bytes as the type of the channel, so a value of another type would be garbage
+    if (channels[channel].type != type) return false;
+    Sample_t sample;
+    sample.time = pros::millis();
+    sample.channel = channel;
+    std::memcpy(sample.bytes, value, 4);
+    if (sampleBuffer.push(sample)) return true;
+    droppedSamples++;
+    return false;
+}
+
+/**
+ * @brief Queue a value of a FLOAT channel to be sent
+ *
+ * @param channel the id of the channel
+ * @param value the value
+ * @return true if the value was queued, false if telemetry isn't running, the channel isn't a FLOAT channel or the
+ * queue is full
+ */
+bool lemlib::telemetry::writeFloat(int channel, float value) {
+    return queueSample(channel, ChannelType::FLOAT, &value);
+}
+
+/**
+ * @brief Queue a value of an INT channel to be sent
+ *
+ * @param channel the id of the channel
+ * @param value the value
+ * @return true if the value was queued, false if telemetry isn't running, the channel isn't an INT channel or the
+ * queue is full
+ */
+bool lemlib::telemetry::writeInt(int channel, std::int32_t value) {
+    return queueSample(channel, ChannelType::INT, &value);
+}
+
+/**
+ * @brief Get the number of samples dropped because the queue was full
+ *
+ * @return int
+ */
+int lemlib::telemetry::getDroppedSamples() { return droppedSamples.load(); }
@@ -97,3 +97,16 @@ double lemlib::avg(std::vector<double> values) {
     for (double value : values) { sum += value; }
     return sum / values.size();
 }
+
+/*omit
+ * @brief Return the average of an array of numbers
+ *
+ * @param values pointer to the first number
+ * @param count how many numbers there are
+ * @return float
+ */
+float lemlib::avg(const float* values, int count) {
+    float sum = 0;
+    for (int i = 0; i < count; i++) { sum += values[i]; }
+    return sum / count;
+}
@@ -0,0 +1,144 @@
+/**
+ * @file tools/host/autotuneSim.cpp
+ * @author LemLib Team
+ * @brief Check the relay autotuner against simulated drivetrains with known ultimate gains and periods
+ * @version 0.4.5
+ * @date 2026-10-19
+ *
+ * Usage: autotuneSim
+ *
+ * Each drivetrain is a delayed double integrator with velocity damping: the motors reach K times the power with time
+ * constant tau, after a delay L. It is integrated every millisecond. The relay is updated every 10 milliseconds like
+ * the chassis, and every millisecond to check the autotuner without sampling error. A pure double integrator has no
+ * ultimate gain, since its phase is below -180 degrees at every frequency, so the damping is what makes the analytic
+ * values exist.
+ *
+ * The hysteresis delays the relay, so it oscillates where the phase of the plant is -180 degrees plus asin(h / a)
+ * rather than at the ultimate frequency. The analytic values are the describing function prediction of what the
+ * autotuner measures, and the true ultimate gain and period are printed alongside them. The relay also only switches
+ * on an update, up to one update after the error crosses the hysteresis, and the oscillation locks to that phase
+ * instead of averaging it out. So the measured values are compared with the prediction between no extra delay and one
+ * update of extra delay, widened by the error of the describing function. Prints the measured values and the range,
+ * and exits with 1 if any are outside it
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#include <cmath>
+#include <cstdio>
+#include <deque>
+#include "lemlib/autotune.hpp"
+
+/**
+ * @brief A simulated drivetrain
+ *
+ * @param name what is simulated
+ * @param gain velocity per unit of power at steady state
+ * @param timeConstant time constant of the motors in seconds
+ * @param delay delay between the output and the motors responding in seconds
+ * @param updatePeriod time between updates of the relay in milliseconds
+ * @param settings the autotuning settings
+ */
+typedef struct {
+        const char* name;
+        double gain;
+        double timeConstant;
+        double delay;
+        int updatePeriod;
+        lemlib::AutotuneSettings_t settings;
+} Plant_t;
+
+// error allowed for the describing function, which only models the fundamental of the oscillation
+constexpr double TOLERANCE = 0.05;
+
+/**
+ * @brief Calculate the ultimate gain and period a relay measures on a plant, according to the describing function
+ *
+ * The plant is K e^(-sL) / (s (tau s + 1)). The relay oscillates at the frequency w where its phase is -180 degrees
+ * plus asin(h / a), with amplitude a = 4d |G(jw)| / pi. With no hysteresis that is the ultimate frequency, where
+ * atan(w tau) + w L = pi / 2
+ *
+ * @param plant the plant
+ * @param extraDelay delay added to the plant in seconds
+ * @param hysteresis hysteresis of the relay
+ * @param gain the measured ultimate gain
+ * @param period the measured ultimate period in milliseconds
+ */
+void analytic(const Plant_t& plant, double extraDelay, double hysteresis, double& gain, double& period) {
+    double delay = plant.delay + extraDelay;
+    double relay = plant.settings.relayAmplitude;
+    auto amplitude = [&](double w) {
+        return 4 * relay / M_PI * plant.gain / (w * std::sqrt(1 + std::pow(w * plant.timeConstant, 2)));
+    };
+    // the phase lag grows with the frequency, and so does the lag of the hysteresis as the amplitude shrinks
+    double low = 0;
+    double high = M_PI / 2 / delay;
+    for (int i = 0; i < 100; i++) {
+        double w = (low + high) / 2;
+        double hysteresisLag = std::asin(std::fmin(1, hysteresis / amplitude(w)));
+        if (std::atan(w * plant.timeConstant) + w * delay + hysteresisLag < M_PI / 2) low = w;
+        else high = w;
+    }
+    double w = (low + high) / 2;
+    double a = amplitude(w);
+    gain = 4 * relay / (M_PI * std::sqrt(std::fmax(a * a - hysteresis * hysteresis, 0)));
+    period = 2 * M_PI / w * 1000;
+}
+
+/**
+ * @brief Run the autotuner against a plant
+ *
+ * @param plant the plant
+ * @return lemlib::AutotuneResult_t
+ */
+lemlib::AutotuneResult_t simulate(const Plant_t& plant) {
+    lemlib::RelayAutotuner tuner(plant.settings);
+    // start away from the target, like a robot that isn't quite at the target heading
+    double position = -5 * plant.settings.hysteresis;
+    double velocity = 0;
+    double output = 0;
+    std::deque<double> delayed(int(std::lround(plant.delay * 1000)), 0.0);
+    for (int millis = 0; millis < plant.settings.timeout && !tuner.isDone(); millis++) {
+        if (millis % plant.updatePeriod == 0) output = tuner.update(-position, millis);
+        delayed.push_back(output);
+        double applied = delayed.front();
+        delayed.pop_front();
+        velocity += (plant.gain * applied - velocity) * 0.001 / plant.timeConstant;
+        position += velocity * 0.001;
+    }
+    return tuner.getResult();
+}
+
+int main() {
+    Plant_t plants[] = {
+        {"lateral, inches", 0.6, 0.15, 0.02, 10, {40, 0.05, 5, 20000}},
+        {"angular, degrees", 4, 0.1, 0.03, 10, {30, 0.2, 5, 20000}},
+        {"slow motors, inches", 0.5, 0.3, 0.01, 10, {50, 0.05, 5, 20000}},
+        {"lateral, inches, 1ms updates", 0.6, 0.15, 0.02, 1, {40, 0.05, 5, 20000}},
+        {"angular, degrees, 1ms updates", 4, 0.1, 0.03, 1, {30, 0.2, 5, 20000}},
+    };
+    int failures = 0;
+    for (const Plant_t& plant : plants) {
+        double ultimateGain, ultimatePeriod;
+        analytic(plant, 0, 0, ultimateGain, ultimatePeriod);
+        // more delay means a lower ultimate gain and a longer period
+        double maxGain, minPeriod, minGain, maxPeriod;
+        double hysteresis = plant.settings.hysteresis;
+        analytic(plant, 0, hysteresis, maxGain, minPeriod);
+        analytic(plant, plant.updatePeriod / 1000.0, hysteresis, minGain, maxPeriod);
+        minGain *= 1 - TOLERANCE;
+        maxGain *= 1 + TOLERANCE;
+        minPeriod *= 1 - TOLERANCE;
+        maxPeriod *= 1 + TOLERANCE;
+        lemlib::AutotuneResult_t result = simulate(plant);
+        bool ok = result.success && result.ultimateGain >= minGain && result.ultimateGain <= maxGain &&
+                  result.ultimatePeriod >= minPeriod && result.ultimatePeriod <= maxPeriod;
+        std::printf("%s %s\n", ok ? "ok  " : "FAIL", plant.name);
+        std::printf("    Ku %.3f, analytic %.3f to %.3f\n", result.ultimateGain, minGain, maxGain);
+        std::printf("    Tu %.1f ms, analytic %.1f to %.1f ms\n", result.ultimatePeriod, minPeriod, maxPeriod);
+        std::printf("    true Ku %.3f, Tu %.1f ms\n", ultimateGain, ultimatePeriod);
+        if (!ok) failures++;
+    }
+    return failures == 0 ? 0 : 1;
+}
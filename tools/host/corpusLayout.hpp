@@ -0,0 +1,21 @@
+/**
+ * @file tools/host/corpusLayout.hpp
+ * @author LemLib Team
+ * @brief Sensor layout of the synthetic recordings
+ * @version 0.4.5
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#pragma once
+
+namespace corpus {
+// one vertical and one horizontal tracking wheel, both 2.75" wheels on rotation sensors, plus an IMU
+constexpr float WHEEL_DIAMETER = 2.75;
+constexpr float VERTICAL_OFFSET = -1.5;
+constexpr float HORIZONTAL_OFFSET = -4;
+// odometry runs every 10 milliseconds
+constexpr int TICK_MS = 10;
+} // namespace corpus
@@ -0,0 +1,106 @@
+/**
+ * @file tools/host/encoderTest.cpp
+ * @author LemLib Team
+ * @brief Check that tracking wheels read every kind of encoder correctly
+ * @version 0.4.5
+ * @date 2026-10-19
+ *
+ * Usage: encoderTest
+ *
+ * The devices read the simulated values in prosStubs.hpp. Prints every check that fails, and exits with 1 if any did
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#include <cmath>
+#include <cstdio>
+#include "lemlib/chassis/trackingWheel.hpp"
+#include "prosStubs.hpp"
+
+int failures = 0;
+
+/**
+ * @brief Check that a value is close to the expected value
+ *
+ * @param name what is checked
+ * @param actual the value
+ * @param expected the expected value
+ */
+void check(const char* name, float actual, float expected) {
+    if (std::fabs(actual - expected) <= 1e-4 * std::fmax(1, std::fabs(expected))) return;
+    std::printf("FAIL %s: %f, expected %f\n", name, actual, expected);
+    failures++;
+}
+
+void testMock() {
+    lemlib::MockEncoder_t encoder = {0, 0};
+    lemlib::TrackingWheel wheel(&encoder, 2.75, -1.5);
+    encoder.position = 2;
+    encoder.velocity = -0.5;
+    check("mock distance", wheel.getDistanceTraveled(), 2 * M_PI * 2.75);
+    check("mock velocity", wheel.updateVelocity(wheel.getDistanceTraveled(), 0.01), -0.5 * M_PI * 2.75);
+    check("mock offset", wheel.getOffset(), -1.5);
+    check("mock type", wheel.getType(), 0);
+    wheel.reset();
+    check("mock reset", wheel.getDistanceTraveled(), 0);
+}
+
+void testAdi() {
+    pros::ADIEncoder encoder('A', 'B');
+    lemlib::TrackingWheel wheel(&encoder, 3.25, 4, 2);
+    host::adiEncoderValues[&encoder] = 720;
+    // 720 ticks is 2 rotations of the encoder, and 1 of the wheel with a gear ratio of 2
+    check("adi distance", wheel.getDistanceTraveled(), M_PI * 3.25);
+    // the velocity is differentiated from the positions of consecutive ticks, and filtered with a weight of 0.3
+    check("adi first velocity", wheel.updateVelocity(wheel.getDistanceTraveled(), 0.01), 0);
+    host::adiEncoderValues[&encoder] = 756;
+    check("adi velocity", wheel.updateVelocity(wheel.getDistanceTraveled(), 0.01), 0.3 * 0.05 * M_PI * 3.25 / 0.01);
+    wheel.reset();
+    check("adi reset", wheel.getDistanceTraveled(), 0);
+}
+
+void testRotation() {
+    pros::Rotation rotation(1);
+    lemlib::TrackingWheel wheel(&rotation, 2, 0);
+    host::rotationPositions[&rotation] = -9000;
+    check("rotation distance", wheel.getDistanceTraveled(), -0.25 * M_PI * 2);
+    // the sensor measures its velocity, filtered with a weight of 0.5
+    host::rotationVelocities[&rotation] = 36000;
+    check("rotation velocity", wheel.updateVelocity(wheel.getDistanceTraveled(), 0.01), 0.5 * M_PI * 2);
+    wheel.reset();
+    check("rotation reset", wheel.getDistanceTraveled(), 0);
+    check("rotation type", wheel.getType(), 0);
+}
+
+void testMotorGroup() {
+    // pros::Motor can't be constructed on the host. The motor group functions used are stubbed by address, so point
+    // at storage for one instead
+    alignas(pros::Motor_Group) unsigned char storage[sizeof(pros::Motor_Group)];
+    pros::Motor_Group* motors = reinterpret_cast<pros::Motor_Group*>(storage);
+    host::motorGroupPorts[motors] = {1, 2};
+    host::motorPositions[1] = 2;
+    host::motorPositions[2] = 4;
+    host::motorVelocities[1] = 200;
+    host::motorVelocities[2] = 400;
+
+    // a copy must keep working after the original is destroyed
+    lemlib::TrackingWheel* original = new lemlib::TrackingWheel(motors, 3.25, 5, 450);
+    lemlib::TrackingWheel wheel = *original;
+    delete original;
+
+    // the stubbed motors are 600 rpm, so the wheels turn 0.75 times per motor rotation
+    check("motor group distance", wheel.getDistanceTraveled(), 3 * 0.75 * M_PI * 3.25);
+    check("motor group velocity", wheel.updateVelocity(wheel.getDistanceTraveled(), 0.01),
+          300 * 0.75 / 60 * M_PI * 3.25);
+    check("motor group type", wheel.getType(), 1);
+}
+
+int main() {
+    testMock();
+    testAdi();
+    testRotation();
+    testMotorGroup();
+    if (failures == 0) std::printf("all encoder checks passed\n");
+    return failures == 0 ? 0 : 1;
+}
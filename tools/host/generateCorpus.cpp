@@ -0,0 +1,168 @@
+/**
+ * @file tools/host/generateCorpus.cpp
+ * @author LemLib Team
+ * @brief Generate synthetic odometry recordings with their ground truth
+ * @version 0.4.5
+ * @date 2026-10-19
+ *
+ * Usage: generateCorpus <directory>
+ *
+ * Every recording is written as <name>.llor, in the format written by lemlib::startRecording(), with the true pose of
+ * every tick and its velocity in <name>.truth.csv. The sensor layout is in corpusLayout.hpp
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "lemlib/chassis/recorder.hpp"
+#include "corpusLayout.hpp"
+
+/**
+ * @brief A part of a route, driven with a constant command
+ *
+ */
+typedef struct {
+        double duration; // seconds
+        double velocity; // inches per second
+        double angularVelocity; // degrees per second, clockwise positive
+} Segment_t;
+
+/**
+ * @brief How the sensors of a recording are degraded
+ *
+ */
+typedef struct {
+        double wheelScaleError; // fraction the tracking wheels overread by
+        double imuNoise; // standard deviation of the IMU noise in degrees
+        double imuDrift; // IMU drift in degrees per minute
+} Noise_t;
+
+/**
+ * @brief Small deterministic random number generator, so the corpus is the same on every computer
+ *
+ */
+class Random {
+    public:
+        double uniform() {
+            state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+            return (state >> 11) * (1.0 / 9007199254740992.0);
+        }
+
+        double gaussian() {
+            double u = std::fmax(uniform(), 1e-12);
+            return std::sqrt(-2 * std::log(u)) * std::cos(2 * M_PI * uniform());
+        }
+    private:
+        std::uint64_t state = 1;
+};
+
+/**
+ * @brief A 60 second skills-like route of drives, turns and arcs
+ *
+ * @return std::vector<Segment_t>
+ */
+std::vector<Segment_t> skillsRoute() {
+    std::vector<Segment_t> route;
+    Random random;
+    double total = 0;
+    while (total < 60) {
+        Segment_t segment;
+        segment.duration = 0.5 + 2 * random.uniform();
+        double kind = random.uniform();
+        if (kind < 0.4) segment = {segment.duration, 70 * (random.uniform() * 2 - 1), 0}; // drive
+        else if (kind < 0.7) segment = {segment.duration, 0, 300 * (random.uniform() * 2 - 1)}; // turn
+        else segment = {segment.duration, 50 * (random.uniform() * 2 - 1), 120 * (random.uniform() * 2 - 1)}; // arc
+        segment.duration = std::fmin(segment.duration, 60 - total);
+        route.push_back(segment);
+        total += segment.duration;
+    }
+    return route;
+}
+
+/**
+ * @brief Simulate a robot driving a route, and write its recording and ground truth
+ *
+ * The robot follows each command with a 0.15 second lag, and is integrated in double precision every millisecond
+ *
+ * @param directory the directory to write to
+ * @param name the name of the recording
+ * @param route the route to drive
+ * @param noise how the sensors are degraded
+ * @return true if the files were written
+ */
+bool generate(const std::string& directory, const std::string& name, const std::vector<Segment_t>& route,
+              Noise_t noise) {
+    std::FILE* recording = std::fopen((directory + "/" + name + ".llor").c_str(), "wb");
+    std::FILE* truth = std::fopen((directory + "/" + name + ".truth.csv").c_str(), "w");
+    if (recording == nullptr || truth == nullptr) return false;
+    lemlib::RecordingHeader_t header;
+    std::memcpy(header.magic, "LLOR", 4);
+    header.version = lemlib::RECORDING_VERSION;
+    header.recordSize = sizeof(lemlib::OdomRecord_t);
+    std::fwrite(&header, sizeof(header), 1, recording);
+    std::fprintf(truth, "time_ms,x,y,theta,speed,angular_velocity\n");
+
+    // resolution of a rotation sensor on the tracking wheels, and of the IMU
+    const double wheelResolution = M_PI * corpus::WHEEL_DIAMETER / 36000;
+    const double imuResolution = 0.01;
+    Random random;
+    double x = 0, y = 0, theta = 0, traveled = 0;
+    double velocity = 0, angularVelocity = 0;
+    int millis = 0;
+    for (const Segment_t& segment : route) {
+        int end = millis + int(std::lround(segment.duration * 1000));
+        while (millis < end) {
+            // integrate one millisecond
+            const double dt = 0.001;
+            velocity += (segment.velocity - velocity) * dt / 0.15;
+            angularVelocity += (M_PI / 180 * segment.angularVelocity - angularVelocity) * dt / 0.15;
+            double midTheta = theta + angularVelocity * dt / 2;
+            x += velocity * dt * std::sin(midTheta);
+            y += velocity * dt * std::cos(midTheta);
+            theta += angularVelocity * dt;
+            traveled += velocity * dt;
+            millis++;
+            if (millis % corpus::TICK_MS != 0) continue;
+
+            // sample the sensors
+            lemlib::OdomRecord_t record = {};
+            record.time = millis;
+            double vertical = (traveled - corpus::VERTICAL_OFFSET * theta) * (1 + noise.wheelScaleError);
+            double horizontal = -corpus::HORIZONTAL_OFFSET * theta * (1 + noise.wheelScaleError);
+            record.vertical1 = std::round(vertical / wheelResolution) * wheelResolution;
+            record.horizontal1 = std::round(horizontal / wheelResolution) * wheelResolution;
+            double imu = theta * 180 / M_PI + noise.imuDrift * millis / 60000.0 + noise.imuNoise * random.gaussian();
+            record.imu = std::round(imu / imuResolution) * imuResolution * M_PI / 180;
+            std::fwrite(&record, sizeof(record), 1, recording);
+            std::fprintf(truth, "%d,%.6f,%.6f,%.6f,%.6f,%.6f\n", millis, x, y, theta * 180 / M_PI, velocity,
+                         angularVelocity * 180 / M_PI);
+        }
+    }
+    std::fclose(recording);
+    std::fclose(truth);
+    return true;
+}
+
+int main(int argc, char** argv) {
+    if (argc != 2) {
+        std::fprintf(stderr, "usage: %s <directory>\n", argv[0]);
+        return 1;
+    }
+    std::string directory = argv[1];
+    std::vector<Segment_t> skills = skillsRoute();
+    std::vector<Segment_t> spin = {{30, 0, 180}};
+    std::vector<Segment_t> straight = {{10, 60, 0}, {10, -60, 0}, {10, 60, 0}};
+    bool ok = generate(directory, "skills60", skills, {0, 0, 0}) &&
+              generate(directory, "skills60Noisy", skills, {0.003, 0.02, 1}) &&
+              generate(directory, "spin30", spin, {0, 0, 0}) && generate(directory, "straight30", straight, {0, 0, 0});
+    if (!ok) {
+        std::fprintf(stderr, "couldn't write to %s\n", directory.c_str());
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,60 @@
+/**
+ * @file tools/host/pidTest.cpp
+ * @author LemLib Team
+ * @brief Check that FAPID updates select the intended overload and scale with the time step
+ * @version 0.4.5
+ * @date 2026-10-19
+ *
+ * Usage: pidTest
+ *
+ * Prints every check that fails, and exits with 1 if any did
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#include <cmath>
+#include <cstdio>
+#include "lemlib/pid.hpp"
+
+int failures = 0;
+
+/**
+ * @brief Check that a value is close to the expected value
+ *
+ * @param name what is checked
+ * @param actual the value
+ * @param expected the expected value
+ */
+void check(const char* name, float actual, float expected) {
+    if (std::fabs(actual - expected) <= 1e-4 * std::fmax(1, std::fabs(expected))) return;
+    std::printf("FAIL %s: %f, expected %f\n", name, actual, expected);
+    failures++;
+}
+
+int main() {
+    // an int, a double and a float dt all call updateDt, and give the same output
+    lemlib::FAPID intPid(0, 0, 1, 0, 1, "int");
+    lemlib::FAPID doublePid(0, 0, 1, 0, 1, "double");
+    lemlib::FAPID floatPid(0, 0, 1, 0, 1, "float");
+    int intDt = 20;
+    double doubleDt = 20;
+    intPid.updateDt(10, 0, intDt);
+    doublePid.updateDt(10, 0, doubleDt);
+    floatPid.updateDt(10, 0, 20.0f);
+    // the error falls by 4 over 20ms, so the derivative is -2 per 10ms
+    float expected = 6 - 2;
+    check("int dt", intPid.updateDt(10, 4, intDt), expected);
+    check("double dt", doublePid.updateDt(10, 4, doubleDt), expected);
+    check("float dt", floatPid.updateDt(10, 4, 20.0f), expected);
+
+    // update() is a 10ms step, and a literal third argument is the log flag, not a dt
+    lemlib::FAPID defaultPid(0, 0, 1, 0, 1, "default");
+    lemlib::FAPID tenPid(0, 0, 1, 0, 1, "ten");
+    defaultPid.update(10, 0, false);
+    tenPid.updateDt(10, 0, 10);
+    check("default dt", defaultPid.update(10, 4), tenPid.updateDt(10, 4, 10));
+
+    if (failures == 0) std::printf("all pid checks passed\n");
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,133 @@
+/**
+ * @file tools/host/prosStubs.cpp
+ * @author LemLib Team
+ * @brief Host stand-ins for the PROS functions used by the odometry code
+ * @version 0.4.5
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include "pros/rtos.hpp"
+#include "pros/motors.hpp"
+#include "pros/adi.hpp"
+#include "pros/rotation.hpp"
+#include "prosStubs.hpp"
+
+std::map<const void*, std::vector<std::uint8_t>> host::motorGroupPorts;
+std::map<std::uint8_t, double> host::motorPositions;
+std::map<std::uint8_t, double> host::motorVelocities;
+std::map<const void*, std::int32_t> host::adiEncoderValues;
+std::map<const void*, std::int32_t> host::rotationPositions;
+std::map<const void*, std::int32_t> host::rotationVelocities;
+
+const auto startTime = std::chrono::steady_clock::now();
+bool manualTime = false;
+std::uint64_t currentMicros = 0;
+
+void host::setTime(std::uint64_t micros) {
+    manualTime = true;
+    currentMicros = micros;
+}
+
+std::uint64_t now() {
+    if (manualTime) return currentMicros;
+    auto elapsed = std::chrono::steady_clock::now() - startTime;
+    return std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count();
+}
+
+// the C API is declared with C linkage, so its definitions keep it
+namespace pros {
+namespace c {
+std::uint32_t millis() { return now() / 1000; }
+
+std::uint64_t micros() { return now(); }
+
+void delay(const std::uint32_t milliseconds) { std::this_thread::sleep_for(std::chrono::milliseconds(milliseconds)); }
+
+double motor_get_position(std::uint8_t port) { return host::motorPositions[port]; }
+
+double motor_get_actual_velocity(std::uint8_t port) { return host::motorVelocities[port]; }
+
+motor_gearset_e_t motor_get_gearing(std::uint8_t) { return E_MOTOR_GEARSET_06; }
+} // namespace c
+} // namespace pros
+
+// tasks run on detached threads
+pros::Task::Task(task_fn_t function, void* parameters, std::uint32_t, std::uint16_t, const char*) {
+    std::thread(function, parameters).detach();
+}
+
+// mutexes are looked up by address, since pros::Mutex has no room for a host mutex
+std::map<const pros::Mutex*, std::unique_ptr<std::timed_mutex>> mutexes;
+std::mutex mutexesLock;
+
+std::timed_mutex& hostMutex(const pros::Mutex* mutex) {
+    std::lock_guard<std::mutex> guard(mutexesLock);
+    std::unique_ptr<std::timed_mutex>& entry = mutexes[mutex];
+    if (entry == nullptr) entry = std::make_unique<std::timed_mutex>();
+    return *entry;
+}
+
+pros::Mutex::Mutex() {}
+
+bool pros::Mutex::take(std::uint32_t timeout) {
+    if (timeout == TIMEOUT_MAX) {
+        hostMutex(this).lock();
+        return true;
+    }
+    return hostMutex(this).try_lock_for(std::chrono::milliseconds(timeout));
+}
+
+bool pros::Mutex::give() {
+    hostMutex(this).unlock();
+    return true;
+}
+
+// motor groups
+std::vector<std::uint8_t> pros::Motor_Group::get_ports() { return host::motorGroupPorts[this]; }
+
+std::int32_t pros::Motor_Group::set_encoder_units(pros::motor_encoder_units_e) { return 1; }
+
+std::int32_t pros::Motor_Group::tare_position() { return 1; }
+
+// adi encoders
+pros::ADIPort::ADIPort(std::uint8_t adi_port, adi_port_config_e_t) : _smart_port(0), _adi_port(adi_port) {}
+
+pros::ADIEncoder::ADIEncoder(std::uint8_t adi_port_top, std::uint8_t, bool) : ADIPort(adi_port_top) {}
+
+std::int32_t pros::ADIEncoder::get_value() const { return host::adiEncoderValues[this]; }
+
+std::int32_t pros::ADIEncoder::reset() const {
+    host::adiEncoderValues[this] = 0;
+    return 1;
+}
+
+// rotation sensors. Every virtual function is defined so the vtable links
+std::int32_t pros::Rotation::reset() { return reset_position(); }
+
+std::int32_t pros::Rotation::set_data_rate(std::uint32_t) const { return 1; }
+
+std::int32_t pros::Rotation::set_position(std::uint32_t position) {
+    host::rotationPositions[this] = position;
+    return 1;
+}
+
+std::int32_t pros::Rotation::reset_position() { return set_position(0); }
+
+std::int32_t pros::Rotation::get_position() { return host::rotationPositions[this]; }
+
+std::int32_t pros::Rotation::get_velocity() { return host::rotationVelocities[this]; }
+
+std::int32_t pros::Rotation::get_angle() { return host::rotationPositions[this] % 36000; }
+
+std::int32_t pros::Rotation::set_reversed(bool) { return 1; }
+
+std::int32_t pros::Rotation::reverse() { return 1; }
+
+std::int32_t pros::Rotation::get_reversed() { return 0; }
@@ -0,0 +1,39 @@
+/**
+ * @file tools/host/prosStubs.hpp
+ * @author LemLib Team
+ * @brief Host stand-ins for the PROS functions used by the odometry code
+ * @version 0.4.5
+ * @date 2026-10-19
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <vector>
+
+namespace host {
+/**
+ * @brief Simulated device readings. Devices that are never set read as 0
+ *
+ * Motors are keyed by port, other devices by their address
+ */
+extern std::map<const void*, std::vector<std::uint8_t>> motorGroupPorts;
+extern std::map<std::uint8_t, double> motorPositions;
+extern std::map<std::uint8_t, double> motorVelocities;
+extern std::map<const void*, std::int32_t> adiEncoderValues;
+extern std::map<const void*, std::int32_t> rotationPositions;
+extern std::map<const void*, std::int32_t> rotationVelocities;
+
+/**
+ * @brief Set the time returned by pros::millis() and pros::micros()
+ *
+ * By default the time is the real time since the program started. Once set, it only changes when set again
+ *
+ * @param micros the time in microseconds
+ */
+void setTime(std::uint64_t micros);
+} // namespace host
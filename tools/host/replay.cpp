@@ -0,0 +1,161 @@
+/**
+ * @file tools/host/replay.cpp
+ * @author LemLib Team
+ * @brief Replay odometry recordings on a computer, and measure their drift and cost
+ * @version 0.4.5
+ * @date 2026-10-19
+ *
+ * Usage: replay <recording> [truth] [--repeat N]
+ *
+ * The recording is replayed through lemlib::Odometry with float and double precision accumulation. For each, the
+ * time per tick and the speedup over real time are printed, and if the ground truth written by generateCorpus is
+ * given, the final and largest position and heading errors and the rms velocity errors. The recording must use the
+ * layout in corpusLayout.hpp
+ *
+ * @copyright Copyright (c) 2023
+ *
+ */
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include "lemlib/chassis/odom.hpp"
+#include "lemlib/chassis/recorder.hpp"
+#include "lemlib/chassis/encoder.hpp"
+#include "corpusLayout.hpp"
+
+/**
+ * @brief A true pose
+ *
+ */
+typedef struct {
+        double x;
+        double y;
+        double theta; // degrees
+        double speed; // inches per second
+        double angularVelocity; // degrees per second
+} Truth_t;
+
+/**
+ * @brief The sensors of the corpus layout. The wheels only set the layout, their readings come from the recording
+ *
+ */
+struct Layout {
+        lemlib::MockEncoder_t verticalEncoder = {0, 0};
+        lemlib::MockEncoder_t horizontalEncoder = {0, 0};
+        lemlib::TrackingWheel vertical {&verticalEncoder, corpus::WHEEL_DIAMETER, corpus::VERTICAL_OFFSET};
+        lemlib::TrackingWheel horizontal {&horizontalEncoder, corpus::WHEEL_DIAMETER, corpus::HORIZONTAL_OFFSET};
+        // update() never reads the IMU, it only needs to know there is one. pros::Imu can't be constructed on the host
+        // without stubbing all of its virtual functions, so point at storage for one instead
+        alignas(pros::Imu) unsigned char imu[sizeof(pros::Imu)];
+
+        lemlib::OdomSensors_t sensors() {
+            pros::Imu* imuPointer = reinterpret_cast<pros::Imu*>(imu);
+            return {&vertical, nullptr, &horizontal, nullptr, imuPointer, {nullptr, nullptr, nullptr}};
+        }
+};
+
+std::vector<Truth_t> readTruth(const char* path) {
+    std::vector<Truth_t> truth;
+    std::FILE* file = std::fopen(path, "r");
+    if (file == nullptr) return truth;
+    char line[128];
+    std::fgets(line, sizeof(line), file); // header
+    int time;
+    Truth_t pose;
+    while (std::fscanf(file, "%d,%lf,%lf,%lf,%lf,%lf", &time, &pose.x, &pose.y, &pose.theta, &pose.speed,
+                       &pose.angularVelocity) == 6)
+        truth.push_back(pose);
+    std::fclose(file);
+    return truth;
+}
+
+/**
+ * @brief Replay a recording one tick at a time, comparing every tick with the ground truth
+ *
+ * @param path the recording
+ * @param truth the true pose of every tick
+ * @param doublePrecision whether to accumulate in double precision
+ */
+void measureDrift(const char* path, const std::vector<Truth_t>& truth, bool doublePrecision) {
+    Layout layout;
+    lemlib::Odometry odometry(layout.sensors(), {nullptr, nullptr, 0, 0, 0});
+    odometry.setDoublePrecision(doublePrecision);
+    std::FILE* file = std::fopen(path, "rb");
+    lemlib::RecordingHeader_t header;
+    std::fread(&header, sizeof(header), 1, file);
+    lemlib::OdomRecord_t record, prevRecord;
+    std::size_t tick = 0;
+    double maxError = 0, finalError = 0, finalHeadingError = 0;
+    double speedSquares = 0, angularSquares = 0;
+    while (tick < truth.size() && std::fread(&record, sizeof(record), 1, file) == 1) {
+        odometry.update(lemlib::toSnapshot(record, (tick == 0) ? record : prevRecord));
+        prevRecord = record;
+        lemlib::Pose pose = odometry.getPose();
+        finalError = std::hypot(pose.x - truth[tick].x, pose.y - truth[tick].y);
+        finalHeadingError = pose.theta - truth[tick].theta;
+        maxError = std::fmax(maxError, finalError);
+        // the truth speed is signed, so compare the forward velocity
+        lemlib::Pose velocity = odometry.getVelocity(true);
+        speedSquares += std::pow(velocity.y - truth[tick].speed, 2);
+        angularSquares += std::pow(velocity.theta - truth[tick].angularVelocity, 2);
+        tick++;
+    }
+    std::fclose(file);
+    std::printf("    drift: final %.4f in, max %.4f in, final heading %.4f deg\n", finalError, maxError,
+                finalHeadingError);
+    if (tick > 0) {
+        std::printf("    velocity: rms error %.3f in/s, angular %.3f deg/s\n", std::sqrt(speedSquares / tick),
+                    std::sqrt(angularSquares / tick));
+    }
+}
+
+int main(int argc, char** argv) {
+    const char* recording = nullptr;
+    const char* truthPath = nullptr;
+    int repeat = 20;
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--repeat") == 0 && i + 1 < argc) repeat = std::atoi(argv[++i]);
+        else if (recording == nullptr) recording = argv[i];
+        else truthPath = argv[i];
+    }
+    if (recording == nullptr) {
+        std::fprintf(stderr, "usage: %s <recording> [truth] [--repeat N]\n", argv[0]);
+        return 1;
+    }
+    std::vector<Truth_t> truth;
+    if (truthPath != nullptr) truth = readTruth(truthPath);
+
+    std::printf("%s\n", recording);
+    for (bool doublePrecision : {false, true}) {
+        std::printf("  %s accumulation\n", doublePrecision ? "double" : "float");
+        // time the replay itself, through the same function the brain uses
+        int ticks = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < repeat; i++) {
+            Layout layout;
+            lemlib::Odometry odometry(layout.sensors(), {nullptr, nullptr, 0, 0, 0});
+            odometry.setDoublePrecision(doublePrecision);
+            std::FILE* file = std::fopen(recording, "rb");
+            if (file == nullptr) {
+                std::fprintf(stderr, "couldn't open %s\n", recording);
+                return 1;
+            }
+            ticks = lemlib::replay(file, odometry);
+            std::fclose(file);
+            if (ticks < 0) {
+                std::fprintf(stderr, "%s is not a recording from this version of LemLib\n", recording);
+                return 1;
+            }
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        double perTick = seconds / (double(ticks) * repeat);
+        std::printf("    %d ticks, %.1f ns per tick, %.0fx faster than real time\n", ticks, perTick * 1e9,
+                    corpus::TICK_MS / 1000.0 / perTick);
+        if (!truth.empty()) measureDrift(recording, truth, doublePrecision);
+    }
+    return 0;
+}
@@ -0,0 +1,156 @@
+#!/usr/bin/env python3
+"""Decode the LemLib binary telemetry stream to CSV.
+
+The stream is written by lemlib::telemetry (include/lemlib/telemetry.hpp). Each
+frame is COBS encoded between 0 bytes and ends with a CRC-16/CCITT-FALSE.
+Anything else on the serial port, like text from the logger, fails the CRC and
+is skipped.
+
+Examples:
+    python3 tools/telemetry_decode.py /dev/ttyACM1 -o run.csv
+    python3 tools/telemetry_decode.py capture.bin --wide -o run.csv
+
+The default output has one row per value: time_ms,channel,value. With --wide
+there is one row per timestamp and one column per channel, written once the
+input ends.
+"""
+
+import argparse
+import csv
+import struct
+import sys
+
+FRAME_CHANNEL = 1
+FRAME_SAMPLES = 2
+TYPE_FLOAT = 0
+TYPE_INT = 1
+
+
+def crc16(data):
+    crc = 0xFFFF
+    for byte in data:
+        crc ^= byte << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021) if crc & 0x8000 else crc << 1
+            crc &= 0xFFFF
+    return crc
+
+
+def cobs_decode(data):
+    """Decode a COBS block. Returns None if the block is malformed."""
+    output = bytearray()
+    index = 0
+    while index < len(data):
+        code = data[index]
+        if code == 0 or index + code > len(data) + 1:
+            return None
+        output += data[index + 1:index + code]
+        index += code
+        if code < 0xFF and index < len(data):
+            output.append(0)
+    return bytes(output)
+
+
+class Decoder:
+    def __init__(self):
+        self.channels = {}  # id -> (name, type)
+        self.bad_frames = 0
+        self.unknown_samples = 0
+
+    def frames(self, chunks):
+        """Split a stream of byte chunks on 0 bytes and yield valid frames."""
+        buffer = bytearray()
+        for chunk in chunks:
+            buffer += chunk
+            *blocks, rest = buffer.split(b"\0")
+            buffer = bytearray(rest)
+            for block in blocks:
+                if not block:
+                    continue
+                frame = cobs_decode(block)
+                if frame is None or len(frame) < 3 or crc16(frame[:-2]) != struct.unpack("<H", frame[-2:])[0]:
+                    self.bad_frames += 1
+                    continue
+                yield frame[:-2]
+
+    def samples(self, chunks):
+        """Yield (time_ms, channel name, value) for every sample in the stream."""
+        for frame in self.frames(chunks):
+            kind = frame[0]
+            if kind == FRAME_CHANNEL and len(frame) >= 3:
+                self.channels[frame[1]] = (frame[3:].decode("ascii", "replace"), frame[2])
+            elif kind == FRAME_SAMPLES and len(frame) >= 6:
+                start, count = struct.unpack_from("<IB", frame, 1)
+                if len(frame) != 6 + count * 6:
+                    self.bad_frames += 1
+                    continue
+                for i in range(count):
+                    channel, offset = frame[6 + i * 6], frame[7 + i * 6]
+                    raw = frame[8 + i * 6:12 + i * 6]
+                    if channel not in self.channels:
+                        # the channel is announced again within a second
+                        self.unknown_samples += 1
+                        continue
+                    name, type_ = self.channels[channel]
+                    value = struct.unpack("<i", raw)[0] if type_ == TYPE_INT else struct.unpack("<f", raw)[0]
+                    yield start + offset, name, value
+
+
+def read_chunks(source):
+    while True:
+        chunk = source.read(4096) if not hasattr(source, "in_waiting") else source.read(max(1, source.in_waiting))
+        if not chunk:
+            return
+        yield chunk
+
+
+def open_input(path, baud):
+    if path == "-":
+        return sys.stdin.buffer
+    if path.startswith("/dev/") or path.upper().startswith("COM"):
+        try:
+            import serial
+        except ImportError:
+            sys.exit("reading a serial port needs pyserial: pip install pyserial")
+        return serial.Serial(path, baud)
+    return open(path, "rb")
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Decode the LemLib binary telemetry stream to CSV.")
+    parser.add_argument("input", help="serial port, capture file, or - for stdin")
+    parser.add_argument("-o", "--output", help="CSV file to write. Standard output by default")
+    parser.add_argument("--baud", type=int, default=115200, help="baud rate of the serial port")
+    parser.add_argument("--wide", action="store_true", help="one row per timestamp and one column per channel")
+    args = parser.parse_args()
+
+    source = open_input(args.input, args.baud)
+    output = open(args.output, "w", newline="") if args.output else sys.stdout
+    writer = csv.writer(output)
+    decoder = Decoder()
+    rows = {}
+    names = []
+    if not args.wide:
+        writer.writerow(["time_ms", "channel", "value"])
+    try:
+        for time, name, value in decoder.samples(read_chunks(source)):
+            if args.wide:
+                if name not in names:
+                    names.append(name)
+                rows.setdefault(time, {})[name] = value
+            else:
+                writer.writerow([time, name, value])
+                output.flush()
+    except KeyboardInterrupt:
+        pass
+    if args.wide:
+        writer.writerow(["time_ms"] + names)
+        for time in sorted(rows):
+            writer.writerow([time] + [rows[time].get(name, "") for name in names])
+    if output is not sys.stdout:
+        output.close()
+    print(f"{decoder.bad_frames} bad frames, {decoder.unknown_samples} samples from unknown channels", file=sys.stderr)
+
+
+if __name__ == "__main__":
+    main()